@@ -0,0 +1,214 @@
+//
+// Heating/cooling integrator benchmark.
+//
+// Builds level 0 from the synthetic IGM in Prob_3d.F90, integrates it with a
+// tight-tolerance reference, then runs every heat_cool_type in
+// bench.heat_cool_types from the same initial state through
+// Nyx::strang_first_step and reports throughput, work counts and the error
+// against the reference.
+//
+// This file takes the place of Source/main.cpp (the local directory comes
+// first in VPATH); the rest of Nyx is linked unchanged.
+//
+
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+
+#include <AMReX_Amr.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+#include <Nyx.H>
+#include <Nyx_F.H>
+
+using namespace amrex;
+
+extern std::string inputs_name;
+
+namespace {
+
+struct BenchResult
+{
+    int  type;
+    Real seconds;
+    Real rhs_evals;
+    Real steps;
+    long ne_iters;
+    long ne_solves;
+    Real max_err_e;
+    Real mean_err_e;
+    Real max_err_T;
+};
+
+void
+restore (MultiFab& S, MultiFab& D, const MultiFab& S0, const MultiFab& D0)
+{
+    MultiFab::Copy(S, S0, 0, 0, S.nComp(), S.nGrow());
+    MultiFab::Copy(D, D0, 0, 0, D.nComp(), D.nGrow());
+}
+
+// One integration of the whole level over dt; returns the slowest rank's time
+Real
+integrate (Nyx& nyx, MultiFab& S, MultiFab& D, Real time, Real dt)
+{
+    long iters, solves;
+    fort_get_ne_iter_stats(&iters, &solves);
+    nyx.get_heat_cool_cost().setVal(0.0);
+
+    ParallelDescriptor::Barrier();
+    const Real strt = ParallelDescriptor::second();
+
+    // strang_first_step integrates over half of the step it is given
+    nyx.strang_first_step(time, 2.0*dt, S, D);
+
+    Real run_time = ParallelDescriptor::second() - strt;
+    ParallelDescriptor::ReduceRealMax(run_time);
+    return run_time;
+}
+
+// Largest and mean relative difference of component comp of a against ref
+void
+rel_error (const MultiFab& a, const MultiFab& ref, int comp, Real& max_err, Real& mean_err)
+{
+    MultiFab diff(a.boxArray(), a.DistributionMap(), 1, 0);
+    MultiFab::Copy(diff, a, comp, 0, 1, 0);
+    MultiFab::Subtract(diff, ref, comp, 0, 1, 0);
+    MultiFab::Divide(diff, ref, comp, 0, 1, 0);
+    diff.abs(0, 1, 0);
+
+    max_err  = diff.norm0(0);
+    mean_err = diff.norm1(0) / a.boxArray().numPts();
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+    amrex::Gpu::LaunchSafeGuard lsg(false);
+
+    if (argc > 1 && !strchr(argv[1], '=')) {
+        inputs_name = argv[1];
+    }
+
+    Vector<int> types {3, 4, 10, 11, 12};
+    int  ref_type  = 12;
+    Real ref_rtol  = 1.0e-10;
+    Real ref_atol  = 1.0e-10;
+    Real rtol      = 1.0e-4;
+    Real atol      = 1.0e-4;
+    Real dt        = 1.0e-4;
+    int  nrepeat   = 3;
+    {
+        ParmParse pp("bench");
+        pp.queryarr("heat_cool_types", types);
+        pp.query("ref_type", ref_type);
+        pp.query("ref_rtol", ref_rtol);
+        pp.query("ref_atol", ref_atol);
+        pp.query("dt", dt);
+        pp.query("nrepeat", nrepeat);
+
+        ParmParse pp_nyx("nyx");
+        pp_nyx.query("sundials_rtol", rtol);
+        pp_nyx.query("sundials_atol", atol);
+    }
+
+    Nyx::alloc_cuda_managed();
+
+    {
+    Amr amr;
+    amr.init(0.0, -1.0);
+
+    Nyx& nyx = dynamic_cast<Nyx&>(amr.getLevel(0));
+    MultiFab& S = nyx.get_new_data(State_Type);
+    MultiFab& D = nyx.get_new_data(DiagEOS_Type);
+    const Real time  = nyx.get_state_data(State_Type).curTime();
+    const Real ncell = S.boxArray().numPts();
+
+    MultiFab S0(S.boxArray(), S.DistributionMap(), S.nComp(), S.nGrow());
+    MultiFab D0(D.boxArray(), D.DistributionMap(), D.nComp(), D.nGrow());
+    MultiFab::Copy(S0, S, 0, 0, S.nComp(), S.nGrow());
+    MultiFab::Copy(D0, D, 0, 0, D.nComp(), D.nGrow());
+
+    amrex::Print() << "HeatCoolBench: " << ncell << " cells, z = "
+                   << 1.0/nyx.get_comoving_a(time) - 1.0 << ", dt = " << dt << "\n";
+
+    Nyx::set_heat_cool_integrator(ref_type, ref_rtol, ref_atol);
+    integrate(nyx, S, D, time, dt);
+
+    MultiFab S_ref(S.boxArray(), S.DistributionMap(), S.nComp(), 0);
+    MultiFab D_ref(D.boxArray(), D.DistributionMap(), D.nComp(), 0);
+    MultiFab::Copy(S_ref, S, 0, 0, S.nComp(), 0);
+    MultiFab::Copy(D_ref, D, 0, 0, D.nComp(), 0);
+
+    Vector<BenchResult> results;
+
+    for (int type : types)
+    {
+        Nyx::set_heat_cool_integrator(type, rtol, atol);
+
+        BenchResult r;
+        r.type    = type;
+        r.seconds = std::numeric_limits<Real>::max();
+
+        for (int rep = 0; rep < nrepeat; ++rep)
+        {
+            restore(S, D, S0, D0);
+            r.seconds = std::min(r.seconds, integrate(nyx, S, D, time, dt));
+        }
+
+        // Counters cover the last repetition only
+        fort_get_ne_iter_stats(&r.ne_iters, &r.ne_solves);
+        ParallelDescriptor::ReduceLongSum(r.ne_iters);
+        ParallelDescriptor::ReduceLongSum(r.ne_solves);
+
+        MultiFab& cost = nyx.get_heat_cool_cost();
+        r.rhs_evals = cost.sum(0);
+        r.steps     = cost.sum(1);
+
+        Real mean_err_T;
+        rel_error(S, S_ref, Eint, r.max_err_e, r.mean_err_e);
+        rel_error(D, D_ref, Temp_comp, r.max_err_T, mean_err_T);
+
+        results.push_back(r);
+    }
+
+    amrex::Print() << "\n"
+                   << std::setw(6)  << "type"
+                   << std::setw(12) << "seconds"
+                   << std::setw(12) << "cells/s"
+                   << std::setw(14) << "rhs/cell"
+                   << std::setw(12) << "steps/cell"
+                   << std::setw(12) << "ne it/solve"
+                   << std::setw(13) << "max err e"
+                   << std::setw(13) << "mean err e"
+                   << std::setw(13) << "max err T" << "\n";
+
+    for (const BenchResult& r : results)
+    {
+        amrex::Print() << std::setw(6)  << r.type
+                       << std::setw(12) << std::setprecision(4) << r.seconds
+                       << std::setw(12) << std::setprecision(4) << ncell / r.seconds
+                       << std::setw(14) << std::setprecision(4) << r.rhs_evals / ncell
+                       << std::setw(12) << std::setprecision(4) << r.steps / ncell
+                       << std::setw(12) << std::setprecision(4)
+                       << (r.ne_solves > 0 ? Real(r.ne_iters) / r.ne_solves : 0.0)
+                       << std::setw(13) << std::setprecision(3) << r.max_err_e
+                       << std::setw(13) << std::setprecision(3) << r.mean_err_e
+                       << std::setw(13) << std::setprecision(3) << r.max_err_T << "\n";
+    }
+    amrex::Print() << "\nrhs/cell and steps/cell are only recorded by the C++ CVODE "
+                   << "integrators (heat_cool_type 10, 11, 12)\n";
+    }
+
+    Nyx::dealloc_cuda_managed();
+
+    }
+    amrex::Finalize();
+    return 0;
+}
@@ -0,0 +1,23 @@
+module probdata_module
+
+      use amrex_fort_module, only : rt => amrex_real
+
+!     Tagging variables
+      integer, save :: max_num_part
+
+!     Log-normal IGM: ln(delta) is a sum of nmodes random plane waves
+      real(rt), save :: sigma_ln, T0, gamma_igm
+      integer , save :: nmodes, kmax, seed
+
+!     Shock-heated filaments along the coordinate axes
+      integer , save :: nfil
+      real(rt), save :: fil_radius, fil_overdensity, T_shock
+
+!     Realization, built in amrex_probinit from seed
+      integer, parameter :: max_modes = 512, max_fil = 64
+      real(rt), save :: kvec(3,max_modes), phase(max_modes)
+      real(rt), save :: fil_center(3,max_fil)
+      integer , save :: fil_dir(max_fil)
+      real(rt), save :: box_lo(3), box_len(3)
+
+end module probdata_module
@@ -0,0 +1,193 @@
+//
+// Hydro stage benchmark.
+//
+// Builds level 0 of one of the HydroTests problems (PROBLEM in the
+// GNUmakefile), takes bench.warmup coarse steps, then times bench.steps
+// more with the hydro stage timers of HydroStageTimers.H on. One JSON
+// record per run is appended to bench.report with the problem and grid
+// sizes, cell updates per second per core and the core-seconds and ns per
+// cell update of each stage; run_bench.sh sweeps the problems, grid sizes
+// and tile sizes.
+//
+// This file takes the place of Source/main.cpp (the local directory comes
+// first in VPATH); the rest of Nyx is linked unchanged.
+//
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+#include <AMReX_Amr.H>
+#include <AMReX_FabArrayBase.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <Nyx.H>
+#include <HydroStageTimers.H>
+
+#ifndef HYDRO_BENCH_PROBLEM
+#define HYDRO_BENCH_PROBLEM "unknown"
+#endif
+
+using namespace amrex;
+
+extern std::string inputs_name;
+
+namespace {
+
+// Run-time settings of the hydro echoed into the report
+const char* nyx_options[] = {"hydro_convert", "hydro_mol", "ppm_type", "riemann_batched",
+                             "hydro_specialize", "hydro_slab_planes", "hydro_skip_tol"};
+
+std::string
+nyx_option (const char* name)
+{
+    ParmParse pp_nyx("nyx");
+    std::string value;
+    if (!pp_nyx.query(name, value))
+        return "null";
+    return "\"" + value + "\"";
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+    if (argc > 1 && !strchr(argv[1], '=')) {
+        inputs_name = argv[1];
+    }
+
+    int steps  = 10;
+    int warmup = 2;
+    std::string report = "hydro_bench.json";
+    {
+        ParmParse pp("bench");
+        pp.query("steps", steps);
+        pp.query("warmup", warmup);
+        pp.query("report", report);
+    }
+
+    int max_grid_size = 0;
+    {
+        ParmParse pp_amr("amr");
+        pp_amr.query("max_grid_size", max_grid_size);
+    }
+
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+#else
+    const int nthreads = 1;
+#endif
+    const int ncores = ParallelDescriptor::NProcs() * nthreads;
+
+    Nyx::alloc_cuda_managed();
+
+    {
+    Amr amr;
+    amr.init(0.0, -1.0);
+
+    if (amr.finestLevel() != 0)
+        amrex::Abort("HydroBench: run with amr.max_level = 0");
+
+    const Box& domain = amr.Geom(0).Domain();
+    const IntVect& tile = FabArrayBase::mfiter_tile_size;
+
+    amrex::Print() << "HydroBench " << HYDRO_BENCH_PROBLEM << ": domain " << domain.size()
+                   << ", max_grid_size " << max_grid_size << ", tile " << tile
+                   << ", " << ParallelDescriptor::NProcs() << " ranks x "
+                   << nthreads << " threads\n";
+
+    // No stop time, so no step is shortened to reach it
+    for (int n = 0; n < warmup; ++n)
+        amr.coarseTimeStep(-1.0);
+
+    HydroStageTimers::enable(true);
+    HydroStageTimers::reset();
+
+    ParallelDescriptor::Barrier();
+    const Real strt = ParallelDescriptor::second();
+
+    for (int n = 0; n < steps; ++n)
+        amr.coarseTimeStep(-1.0);
+
+    Real wall = ParallelDescriptor::second() - strt;
+    ParallelDescriptor::ReduceRealMax(wall);
+
+    Vector<Real> seconds;
+    long ncells;
+    HydroStageTimers::totals(seconds, ncells);
+
+    const Real rate = (wall > 0.0) ? ncells / (wall * ncores) : 0.0;
+
+    amrex::Print() << "\n" << ncells << " cell updates in " << wall << " s: "
+                   << rate << " cell updates per second per core\n\n"
+                   << std::setw(14) << "stage"
+                   << std::setw(14) << "core-s"
+                   << std::setw(14) << "ns/cell"
+                   << std::setw(10) << "share" << "\n";
+
+    for (int s = 0; s < HydroStageTimers::NumStages; ++s)
+    {
+        if (seconds[s] == 0.0) continue;
+        amrex::Print() << std::setw(14) << HydroStageTimers::name(s)
+                       << std::setw(14) << std::setprecision(4) << seconds[s]
+                       << std::setw(14) << std::setprecision(4)
+                       << (ncells > 0 ? 1.e9 * seconds[s] / ncells : 0.0)
+                       << std::setw(10) << std::setprecision(3)
+                       << seconds[s] / (wall * ncores) << "\n";
+    }
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream os(report, std::ios::app);
+        if (!os.good())
+            amrex::FileOpenFailed(report);
+
+        os << std::setprecision(8)
+           << "{\"problem\": \"" << HYDRO_BENCH_PROBLEM << "\""
+           << ", \"n_cell\": [" << domain.length(0) << ", " << domain.length(1)
+           << ", " << domain.length(2) << "]"
+           << ", \"max_grid_size\": " << max_grid_size
+           << ", \"tile_size\": [" << tile[0] << ", " << tile[1] << ", " << tile[2] << "]"
+           << ", \"ranks\": " << ParallelDescriptor::NProcs()
+           << ", \"threads\": " << nthreads
+           << ", \"steps\": " << steps
+           << ", \"cell_updates\": " << ncells
+           << ", \"wall_seconds\": " << wall
+           << ", \"cell_updates_per_sec_per_core\": " << rate;
+
+        os << ", \"options\": {";
+        for (int i = 0; i < int(sizeof(nyx_options)/sizeof(nyx_options[0])); ++i)
+            os << (i ? ", " : "") << "\"" << nyx_options[i] << "\": " << nyx_option(nyx_options[i]);
+        os << "}";
+
+        os << ", \"stages\": {";
+        bool first = true;
+        for (int s = 0; s < HydroStageTimers::NumStages; ++s)
+        {
+            if (seconds[s] == 0.0) continue;
+            os << (first ? "" : ", ") << "\"" << HydroStageTimers::name(s) << "\": "
+               << "{\"core_seconds\": " << seconds[s]
+               << ", \"ns_per_cell\": " << (ncells > 0 ? 1.e9 * seconds[s] / ncells : 0.0)
+               << "}";
+            first = false;
+        }
+        os << "}}\n";
+    }
+    }
+
+    Nyx::dealloc_cuda_managed();
+
+    }
+    amrex::Finalize();
+    return 0;
+}
@@ -0,0 +1,76 @@
+#!/bin/bash
+#
+# Sweep the HydroBench driver over the HydroTests problems, grid sizes and
+# tile sizes. Each run appends one JSON record to $REPORT.
+#
+#   PROBLEMS="Sod Sedov" SIZES="64 128" TILES="1024,16,16 32,8,8" ./run_bench.sh
+#
+# Extra arguments are passed to every run, e.g. nyx.hydro_specialize=1.
+# Set RUN="mpiexec -n 4" to run under MPI (build with USE_MPI=TRUE).
+#
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+TESTS=$HERE/../HydroTests
+
+PROBLEMS=${PROBLEMS:-"Sod Sedov StrongShockTube DoubleRarefaction TurbForce"}
+SIZES=${SIZES:-"64 128"}
+MAX_GRID_SIZE=${MAX_GRID_SIZE:-64}
+TILES=${TILES:-"1024,16,16 1024,8,8 32,8,8"}
+STEPS=${STEPS:-10}
+WARMUP=${WARMUP:-2}
+REPORT=${REPORT:-$HERE/hydro_bench.json}
+RUN=${RUN:-}
+MAKE_ARGS=${MAKE_ARGS:-}
+
+inputs_of () {
+    case $1 in
+        Sod)               echo "inputs-sod-x probin-sod-x" ;;
+        Sedov)             echo "inputs.3d.sph probin.3d.sph" ;;
+        StrongShockTube)   echo "inputs-x probin-test3-x" ;;
+        DoubleRarefaction) echo "inputs-test2-x probin-test2-x" ;;
+        TurbForce)         echo "inputs probin" ;;
+        *) echo "run_bench.sh: unknown problem $1" >&2; exit 1 ;;
+    esac
+}
+
+mkdir -p "$HERE/bin" "$HERE/run"
+
+# The problems share object names (Prob_3d.f90, ...), so build each from clean
+for p in $PROBLEMS; do
+    (cd "$HERE" && make PROBLEM=$p $MAKE_ARGS clean > /dev/null && make PROBLEM=$p $MAKE_ARGS -j)
+    cp "$HERE"/HydroBench_${p}3d*.ex "$HERE/bin/HydroBench_$p.ex"
+done
+
+for p in $PROBLEMS; do
+    read inputs probin <<< "$(inputs_of $p)"
+
+    for n in $SIZES; do
+        for tile in $TILES; do
+            echo "== $p n_cell=$n tile=$tile"
+            (cd "$HERE/run" && $RUN "$HERE/bin/HydroBench_$p.ex" "$TESTS/$p/$inputs" \
+                amr.probin_file="$TESTS/$p/$probin" \
+                amr.max_level=0 \
+                geometry.prob_hi="1 1 1" \
+                amr.n_cell="$n $n $n" \
+                amr.max_grid_size=$MAX_GRID_SIZE \
+                fabarray.mfiter_tile_size="${tile//,/ }" \
+                nyx.hydro_convert=1 \
+                nyx.ppm_type=0 \
+                amr.plot_int=-1 \
+                amr.check_int=-1 \
+                amr.checkpoint_files_output=0 \
+                amr.plot_files_output=0 \
+                nyx.sum_interval=-1 \
+                nyx.v=0 \
+                amr.v=0 \
+                bench.steps=$STEPS \
+                bench.warmup=$WARMUP \
+                bench.report="$REPORT" \
+                "$@")
+        done
+    done
+done
+
+echo "Results in $REPORT"
@@ -0,0 +1,94 @@
+#!/bin/bash
+#
+# Compare the method-of-lines hydro (nyx.hydro_mol = 1) with CTU on the Sod,
+# DoubleRarefaction and Sedov tests, and scan the CFL number MOL runs at.
+#
+#   PROBLEMS="Sod Sedov" CFLS="0.3 0.5 0.7" ./compare_mol_ctu.sh
+#
+# Each problem is built in its own directory. Then the CTU inputs and the MOL
+# inputs are run to their stop_time, and fcompare prints the L1 norm of the
+# difference of the final plotfiles. MOL is then rerun at each CFL number in
+# CFLS; a run that aborts (negative density, dt_cutoff, ...) is reported as
+# failed.
+# The summary goes to $REPORT.
+#
+# Needs AMREX_HOME, and fcompare built in $AMREX_HOME/Tools/Plotfile.
+# Set RUN="mpiexec -n 4" to run under MPI (build with USE_MPI=TRUE).
+#
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+
+PROBLEMS=${PROBLEMS:-"Sod DoubleRarefaction Sedov"}
+CFLS=${CFLS:-"0.3 0.5 0.7 0.9"}
+REPORT=${REPORT:-$HERE/mol_ctu_report.txt}
+RUN=${RUN:-}
+MAKE_ARGS=${MAKE_ARGS:-}
+FCOMPARE=${FCOMPARE:-$(ls "$AMREX_HOME"/Tools/Plotfile/fcompare*.ex 2>/dev/null | head -1)}
+
+if [ ! -x "$FCOMPARE" ]; then
+    echo "compare_mol_ctu.sh: build fcompare in \$AMREX_HOME/Tools/Plotfile or set FCOMPARE" >&2
+    exit 1
+fi
+
+inputs_of () {
+    case $1 in
+        Sod)               echo "inputs-sod-x inputs-sod-x-mol probin-sod-x" ;;
+        DoubleRarefaction) echo "inputs-test2-x inputs-test2-x-mol probin-test2-x" ;;
+        Sedov)             echo "inputs.3d.sph inputs.3d.sph.mol probin.3d.sph" ;;
+        *) echo "compare_mol_ctu.sh: unknown problem $1" >&2; exit 1 ;;
+    esac
+}
+
+# The last plotfile written under the root name $1
+last_plotfile () {
+    ls -d "$1"[0-9]* 2>/dev/null | grep -v '\.old\.' | sort | tail -1
+}
+
+# Run one case in the current directory; the plotfiles go to $1*
+run_case () {
+    local plt=$1 inputs=$2 probin=$3
+    shift 3
+    $RUN "$exe" "$inputs" amr.probin_file="$probin" \
+        amr.plot_file="$plt" amr.check_int=-1 amr.checkpoint_files_output=0 \
+        "$@" > "$plt.log" 2>&1
+}
+
+: > "$REPORT"
+
+for p in $PROBLEMS; do
+    read ctu mol probin <<< "$(inputs_of $p)"
+    dir=$HERE/$p
+
+    (cd "$dir" && make $MAKE_ARGS -j)
+    exe=$(ls "$dir"/Nyx3d*.ex | head -1)
+
+    rm -rf "$dir/mol_ctu" && mkdir -p "$dir/mol_ctu"
+    cd "$dir/mol_ctu"
+
+    echo "== $p" | tee -a "$REPORT"
+
+    run_case plt_ctu_ "$dir/$ctu" "$dir/$probin"
+    run_case plt_mol_ "$dir/$mol" "$dir/$probin"
+
+    echo "-- L1 norm of MOL - CTU at stop_time (cfl of the inputs)" | tee -a "$REPORT"
+    "$FCOMPARE" --norm 1 "$(last_plotfile plt_ctu_)" "$(last_plotfile plt_mol_)" \
+        | tee -a "$REPORT" || true
+
+    echo "-- MOL CFL scan" | tee -a "$REPORT"
+    for cfl in $CFLS; do
+        plt=plt_mol_cfl${cfl}_
+        if run_case $plt "$dir/$mol" "$dir/$probin" nyx.cfl=$cfl; then
+            l1=$("$FCOMPARE" --norm 1 "$(last_plotfile plt_ctu_)" "$(last_plotfile $plt)" \
+                 | awk '$1 == "density" {print $2}')
+            echo "cfl = $cfl: ran to stop_time, L1(density) vs CTU = $l1" | tee -a "$REPORT"
+        else
+            echo "cfl = $cfl: failed (see $dir/mol_ctu/$plt.log)" | tee -a "$REPORT"
+        fi
+    done
+
+    cd "$HERE"
+done
+
+echo "Results in $REPORT"
@@ -0,0 +1,232 @@
+//
+// Riemann solver microbenchmark.
+//
+// Fills random left/right interface states for bench.nrows rows of
+// bench.nrow_faces faces. Then, for several solver settings, it times two
+// forms of the batched CGF kernel in Source/Hydro/Nyx_riemann_row.H:
+//
+//   - the generic instance, which reads the options and the passive count
+//     at run time inside the face loop (like riemannus in riemann_nd.F90);
+//   - the variant specialized at compile time for those settings.
+//
+// It reports the throughput per face of each, and the largest relative
+// difference between their fluxes, which should be zero.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <Nyx_riemann_row.H>
+
+using namespace amrex;
+
+namespace {
+
+constexpr int nin  = 8;   // rho, un, ut1, ut2, p, rhoe, c, gamc
+constexpr int nout = 12;  // 6 fluxes and 6 Godunov components
+
+struct Side
+{
+    Vector<Vector<Real>> var;   // nin arrays
+    Vector<Vector<Real>> pass;  // npass arrays
+};
+
+struct Result
+{
+    Vector<Vector<Real>> var;   // nout arrays
+    Vector<Vector<Real>> pass;  // npass arrays
+};
+
+void
+fill_side (Side& s, long n, int npass, Real gamma, bool vary_gamma, std::mt19937_64& gen)
+{
+    std::uniform_real_distribution<Real> unif(0.0, 1.0);
+
+    s.var.assign(nin, Vector<Real>(n));
+    s.pass.assign(npass, Vector<Real>(n));
+
+    for (long i = 0; i < n; ++i)
+    {
+        // Log-uniform density and pressure over four decades, transonic velocities
+        const Real rho  = std::pow(10.0, 4.0*unif(gen) - 2.0);
+        const Real p    = std::pow(10.0, 4.0*unif(gen) - 2.0);
+        const Real gamc = vary_gamma ? gamma*(0.9 + 0.2*unif(gen)) : gamma;
+        const Real c    = std::sqrt(gamc*p/rho);
+
+        s.var[0][i] = rho;
+        s.var[1][i] = c*(4.0*unif(gen) - 2.0);
+        s.var[2][i] = c*(2.0*unif(gen) - 1.0);
+        s.var[3][i] = c*(2.0*unif(gen) - 1.0);
+        s.var[4][i] = p;
+        s.var[5][i] = p/(gamc - 1.0);
+        s.var[6][i] = c;
+        s.var[7][i] = gamc;
+
+        for (int m = 0; m < npass; ++m)
+            s.pass[m][i] = unif(gen);
+    }
+}
+
+// Time one sweep over all rows with the given kernel; returns seconds
+template <class F>
+Real
+sweep (F&& kernel, const Side& L, const Side& R, Result& out,
+       int nrow_faces, int nrows, int npass, const RiemannParams& rp)
+{
+    Vector<const Real*> lpass(npass), rpass(npass);
+    Vector<Real*> fpass(npass);
+
+    const Real strt = amrex::second();
+
+    for (int r = 0; r < nrows; ++r)
+    {
+        const long off = static_cast<long>(r)*nrow_faces;
+
+        for (int m = 0; m < npass; ++m) {
+            lpass[m] = L.pass[m].data() + off;
+            rpass[m] = R.pass[m].data() + off;
+            fpass[m] = out.pass[m].data() + off;
+        }
+
+        const RiemannRowIn Lr {L.var[0].data()+off, L.var[1].data()+off, L.var[2].data()+off,
+                               L.var[3].data()+off, L.var[4].data()+off, L.var[5].data()+off,
+                               L.var[6].data()+off, L.var[7].data()+off, lpass.data()};
+        const RiemannRowIn Rr {R.var[0].data()+off, R.var[1].data()+off, R.var[2].data()+off,
+                               R.var[3].data()+off, R.var[4].data()+off, R.var[5].data()+off,
+                               R.var[6].data()+off, R.var[7].data()+off, rpass.data()};
+
+        Vector<Real*> o(nout);
+        for (int v = 0; v < nout; ++v) o[v] = out.var[v].data() + off;
+
+        const RiemannRowOut Fr {o[0], o[1], o[2], o[3], o[4], o[5], fpass.data(),
+                                o[6], o[7], o[8], o[9], o[10], o[11]};
+
+        kernel(nrow_faces, Lr, Rr, Fr, rp);
+    }
+
+    return amrex::second() - strt;
+}
+
+Real
+max_rel_diff (const Result& a, const Result& b)
+{
+    Real err = 0.0;
+    auto cmp = [&err] (const Vector<Real>& x, const Vector<Real>& y) {
+        for (long i = 0; i < x.size(); ++i) {
+            const Real scale = std::max(std::abs(y[i]), 1.e-300);
+            err = std::max(err, std::abs(x[i] - y[i])/scale);
+        }
+    };
+    for (int v = 0; v < a.var.size(); ++v)  cmp(a.var[v],  b.var[v]);
+    for (int m = 0; m < a.pass.size(); ++m) cmp(a.pass[m], b.pass[m]);
+    return err;
+}
+
+std::string
+opts_name (int opts)
+{
+    std::string s = (opts & RiemannOpt::GammaLaw) ? "gamma-law" : "general-EOS";
+    if (opts & RiemannOpt::AnalRiem)    s += "+analriem";
+    if (opts & RiemannOpt::CsmallGamma) s += "+csmall_gamma";
+    if (opts & RiemannOpt::GammaMinus)  s += "+gamma_minus";
+    return s;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+    int  nrow_faces = 66;
+    int  nrows      = 4096;
+    int  npass      = 2;
+    int  nrepeat    = 20;
+    int  seed       = 42;
+    Real gamma      = 5.0/3.0;
+    Real small_dens = 1.e-2;
+    Real small_pres = 1.e-8;
+    {
+        ParmParse pp("bench");
+        pp.query("nrow_faces", nrow_faces);
+        pp.query("nrows", nrows);
+        pp.query("npass", npass);
+        pp.query("nrepeat", nrepeat);
+        pp.query("seed", seed);
+        pp.query("gamma", gamma);
+        pp.query("small_dens", small_dens);
+        pp.query("small_pres", small_pres);
+    }
+
+    const long nface = static_cast<long>(nrow_faces)*nrows;
+
+    // Nyx's default settings first, then with each option switched off in turn
+    const int nyx_default = RiemannOpt::GammaLaw | RiemannOpt::AnalRiem
+                          | RiemannOpt::CsmallGamma | RiemannOpt::GammaMinus;
+    const Vector<int> settings {nyx_default,
+                                nyx_default & ~RiemannOpt::AnalRiem,
+                                nyx_default & ~RiemannOpt::CsmallGamma,
+                                nyx_default & ~RiemannOpt::GammaMinus,
+                                RiemannOpt::GammaLaw,
+                                RiemannOpt::CsmallGamma | RiemannOpt::GammaMinus};
+
+    amrex::Print() << "RiemannBench: " << nrows << " rows of " << nrow_faces
+                   << " faces, " << npass << " passive quantities\n\n"
+                   << std::left << std::setw(48) << "solver settings" << std::right
+                   << std::setw(14) << "generic ns/f"
+                   << std::setw(14) << "special ns/f"
+                   << std::setw(10) << "speedup"
+                   << std::setw(13) << "max rel diff" << "\n";
+
+    for (int opts : settings)
+    {
+        const bool general_eos = !(opts & RiemannOpt::GammaLaw);
+
+        std::mt19937_64 gen(seed);
+        Side L, R;
+        fill_side(L, nface, npass, gamma, general_eos, gen);
+        fill_side(R, nface, npass, gamma, general_eos, gen);
+
+        Result generic, special;
+        for (Result* res : {&generic, &special}) {
+            res->var.assign(nout, Vector<Real>(nface));
+            res->pass.assign(npass, Vector<Real>(nface));
+        }
+
+        const RiemannParams rp {gamma, small_dens, small_pres, opts, npass};
+
+        Real t_generic = std::numeric_limits<Real>::max();
+        Real t_special = std::numeric_limits<Real>::max();
+
+        for (int rep = 0; rep < nrepeat; ++rep)
+        {
+            t_generic = std::min(t_generic,
+                                 sweep(riemann_cgf_row<-1,-1>, L, R, generic,
+                                       nrow_faces, nrows, npass, rp));
+            t_special = std::min(t_special,
+                                 sweep(riemann_cgf_row_dispatch, L, R, special,
+                                       nrow_faces, nrows, npass, rp));
+        }
+
+        amrex::Print() << std::left << std::setw(48) << opts_name(opts) << std::right
+                       << std::setw(14) << std::setprecision(4) << 1.e9*t_generic/nface
+                       << std::setw(14) << std::setprecision(4) << 1.e9*t_special/nface
+                       << std::setw(10) << std::setprecision(3) << t_generic/t_special
+                       << std::setw(13) << std::setprecision(3) << max_rel_diff(special, generic)
+                       << "\n";
+    }
+    }
+    amrex::Finalize();
+    return 0;
+}
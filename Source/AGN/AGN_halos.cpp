@@ -360,6 +360,7 @@ Nyx::agn_halo_find (Real dt)
        Real a = get_comoving_a(new_a_time);
        Nyx::theAPC()->ReleaseEnergy(level, new_state, D_new, a);
        // Now new_state = get_new_data(State_Type) has been updated.
+       diag_eos_current = false;
 
        //       Print() << "Step " << nStep() << " at end of Nyx_halos:" << endl;
        //       Nyx::theAPC()->writeAllAtLevel(level);
@@ -432,5 +433,6 @@ Nyx::agn_halo_accrete (Real dt)
    //       << Nyx::theAPC()->TotalNumberOfParticles(true, true) << endl;
    Nyx::theAPC()->ComputeParticleVelocity(level, orig_state, new_state, add_energy);
    // Now new_state = get_new_data(State_Type) has been updated.
+   diag_eos_current = false;
 }
 #endif // AGN
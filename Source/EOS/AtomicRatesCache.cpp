@@ -0,0 +1,43 @@
+#include <cstdint>
+
+#include <AtomicRatesCache.H>
+#include <Nyx_F.H>
+
+using namespace amrex;
+
+Vector<Real> AtomicRatesCache::m_storage;
+Real*        AtomicRatesCache::m_tab    = nullptr;
+int          AtomicRatesCache::m_ld     = 0;
+Real         AtomicRatesCache::m_z      = 0.0;
+bool         AtomicRatesCache::m_have_z = false;
+
+void
+AtomicRatesCache::init ()
+{
+    constexpr int align     = 64;
+    constexpr int per_line  = align / sizeof(Real);
+    const int     nbins     = fort_get_ncooltab() + 1;
+
+    // Pad each row to whole cache lines, and the block by one line for alignment
+    m_ld = ((nbins + per_line - 1) / per_line) * per_line;
+    m_storage.assign(static_cast<size_t>(NumRates) * m_ld + per_line, 0.0);
+
+    std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(m_storage.data());
+    addr = (addr + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+    m_tab = reinterpret_cast<Real*>(addr);
+
+    fort_set_rate_table(m_tab, m_ld, NumRates);
+
+    invalidate();
+}
+
+void
+AtomicRatesCache::interp_to_z (Real z)
+{
+    if (m_have_z && z == m_z)
+        return;
+
+    fort_interp_to_this_z(&z);
+    m_z      = z;
+    m_have_z = true;
+}
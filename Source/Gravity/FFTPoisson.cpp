@@ -0,0 +1,496 @@
+#include <cmath>
+
+#include <AMReX_ParallelDescriptor.H>
+
+#include "FFTPoisson.H"
+
+#if defined(NYX_USE_FFTW) && !defined(BL_USE_FLOAT)
+#define FFTPOISSON_FFTW
+#include <fftw3.h>
+#endif
+
+using namespace amrex;
+
+// ************************************************************************** //
+//   1D transforms
+// ************************************************************************** //
+
+//
+// Unnormalized complex FFT of length n, in place. Without FFTW, lengths that
+// are powers of two take an iterative radix-2 transform; other lengths use
+// Bluestein's algorithm, a convolution done with radix-2 transforms of a
+// power of two >= 2n-1.
+//
+class FFTPoisson::LineFFT
+{
+public:
+
+    explicit LineFFT (int n);
+    ~LineFFT ();
+
+    int size () const { return m_n; }
+
+    // Complex values of scratch that forward and backward need
+    int work_size () const;
+
+    void forward  (Complex* x, Complex* work) const;
+    void backward (Complex* x, Complex* work) const;
+
+private:
+
+    int m_n;
+
+#ifdef FFTPOISSON_FFTW
+    fftw_plan m_fwd;
+    fftw_plan m_bwd;
+#else
+    void radix2 (Complex* x) const;
+
+    int m_m;                       // length of the radix-2 transforms
+    Vector<int>     m_rev;         // bit reversal permutation of 0..m_m-1
+    Vector<Complex> m_twiddle;     // exp(-2 pi i k / m_m), k < m_m/2
+    Vector<Complex> m_chirp;       // exp(-pi i k^2 / n), Bluestein only
+    Vector<Complex> m_chirp_hat;   // FFT of the conjugate chirp over m_m
+#endif
+};
+
+#ifdef FFTPOISSON_FFTW
+
+FFTPoisson::LineFFT::LineFFT (int n)
+    : m_n(n)
+{
+    fftw_complex* buf = fftw_alloc_complex(n);
+    m_fwd = fftw_plan_dft_1d(n, buf, buf, FFTW_FORWARD,  FFTW_ESTIMATE | FFTW_UNALIGNED);
+    m_bwd = fftw_plan_dft_1d(n, buf, buf, FFTW_BACKWARD, FFTW_ESTIMATE | FFTW_UNALIGNED);
+    fftw_free(buf);
+}
+
+FFTPoisson::LineFFT::~LineFFT ()
+{
+    fftw_destroy_plan(m_fwd);
+    fftw_destroy_plan(m_bwd);
+}
+
+int
+FFTPoisson::LineFFT::work_size () const
+{
+    return 0;
+}
+
+void
+FFTPoisson::LineFFT::forward (Complex* x, Complex* /*work*/) const
+{
+    fftw_complex* p = reinterpret_cast<fftw_complex*>(x);
+    fftw_execute_dft(m_fwd, p, p);
+}
+
+void
+FFTPoisson::LineFFT::backward (Complex* x, Complex* /*work*/) const
+{
+    fftw_complex* p = reinterpret_cast<fftw_complex*>(x);
+    fftw_execute_dft(m_bwd, p, p);
+}
+
+#else
+
+FFTPoisson::LineFFT::LineFFT (int n)
+    : m_n(n)
+{
+    const bool pow2 = (n & (n-1)) == 0;
+
+    m_m = 1;
+    while (m_m < (pow2 ? n : 2*n-1)) m_m <<= 1;
+
+    int bits = 0;
+    while ((1 << bits) < m_m) ++bits;
+
+    m_rev.resize(m_m);
+    for (int i = 0; i < m_m; ++i)
+    {
+        int r = 0;
+        for (int b = 0; b < bits; ++b)
+            if (i & (1 << b)) r |= 1 << (bits-1-b);
+        m_rev[i] = r;
+    }
+
+    m_twiddle.resize(std::max(m_m/2, 1));
+    for (int k = 0; k < m_m/2; ++k)
+    {
+        const Real theta = -2.0 * M_PI * k / m_m;
+        m_twiddle[k] = Complex(std::cos(theta), std::sin(theta));
+    }
+
+    if (!pow2)
+    {
+        // k^2 is taken mod 2n so the angle stays accurate for long lines
+        m_chirp.resize(n);
+        for (int k = 0; k < n; ++k)
+        {
+            const long long k2 = (static_cast<long long>(k) * k) % (2LL * n);
+            const Real theta = -M_PI * k2 / n;
+            m_chirp[k] = Complex(std::cos(theta), std::sin(theta));
+        }
+
+        m_chirp_hat.assign(m_m, Complex(0.0, 0.0));
+        m_chirp_hat[0] = std::conj(m_chirp[0]);
+        for (int k = 1; k < n; ++k)
+        {
+            m_chirp_hat[k]       = std::conj(m_chirp[k]);
+            m_chirp_hat[m_m - k] = std::conj(m_chirp[k]);
+        }
+        radix2(m_chirp_hat.dataPtr());
+        for (Complex& c : m_chirp_hat)
+            c /= Real(m_m);
+    }
+}
+
+FFTPoisson::LineFFT::~LineFFT () {}
+
+int
+FFTPoisson::LineFFT::work_size () const
+{
+    return m_chirp.empty() ? 0 : m_m;
+}
+
+void
+FFTPoisson::LineFFT::radix2 (Complex* x) const
+{
+    for (int i = 0; i < m_m; ++i)
+        if (i < m_rev[i]) std::swap(x[i], x[m_rev[i]]);
+
+    for (int len = 2; len <= m_m; len <<= 1)
+    {
+        const int half   = len / 2;
+        const int stride = m_m / len;
+        for (int i = 0; i < m_m; i += len)
+        {
+            for (int k = 0; k < half; ++k)
+            {
+                const Complex u = x[i+k];
+                const Complex v = x[i+k+half] * m_twiddle[k*stride];
+                x[i+k]      = u + v;
+                x[i+k+half] = u - v;
+            }
+        }
+    }
+}
+
+void
+FFTPoisson::LineFFT::forward (Complex* x, Complex* work) const
+{
+    if (m_chirp.empty())
+    {
+        radix2(x);
+        return;
+    }
+
+    // X_k = c_k sum_j (x_j c_j) conj(c_{k-j}) with c_j = exp(-pi i j^2 / n)
+    for (int k = 0; k < m_n; ++k)
+        work[k] = x[k] * m_chirp[k];
+    for (int k = m_n; k < m_m; ++k)
+        work[k] = Complex(0.0, 0.0);
+
+    radix2(work);
+    for (int k = 0; k < m_m; ++k)
+        work[k] = std::conj(work[k] * m_chirp_hat[k]);
+    radix2(work);
+
+    for (int k = 0; k < m_n; ++k)
+        x[k] = std::conj(work[k]) * m_chirp[k];
+}
+
+void
+FFTPoisson::LineFFT::backward (Complex* x, Complex* work) const
+{
+    for (int k = 0; k < m_n; ++k)
+        x[k] = std::conj(x[k]);
+    forward(x, work);
+    for (int k = 0; k < m_n; ++k)
+        x[k] = std::conj(x[k]);
+}
+
+#endif
+
+// ************************************************************************** //
+//   The solver
+// ************************************************************************** //
+
+namespace
+{
+    //
+    // Pencils of domain along dir: the plane normal to dir cut into pa x pb
+    // pieces, with pa * pb as close to nprocs as that plane allows and the
+    // pieces as square as possible.
+    //
+    BoxArray
+    make_pencils (const Box& domain, int dir, int nprocs)
+    {
+        const int a  = (dir + 1) % AMREX_SPACEDIM;
+        const int b  = (dir + 2) % AMREX_SPACEDIM;
+        const int na = domain.length(a);
+        const int nb = domain.length(b);
+
+        int pa = 1, pb = 1;
+        for (int np = std::min(nprocs, na*nb); np >= 1; --np)
+        {
+            Real best = -1.0;
+            for (int p = 1; p <= np; ++p)
+            {
+                if (np % p != 0 || p > na || np / p > nb) continue;
+                const Real wa = Real(na) / p;
+                const Real wb = Real(nb) / (np / p);
+                const Real shape = std::min(wa, wb) / std::max(wa, wb);
+                if (shape > best)
+                {
+                    best = shape;
+                    pa = p;
+                    pb = np / p;
+                }
+            }
+            if (best > 0.0) break;
+        }
+
+        BoxList bl;
+        for (int ib = 0; ib < pb; ++ib)
+        {
+            for (int ia = 0; ia < pa; ++ia)
+            {
+                Box bx = domain;
+                bx.setSmall(a, domain.smallEnd(a) + (ia     * na) / pa);
+                bx.setBig  (a, domain.smallEnd(a) + ((ia+1) * na) / pa - 1);
+                bx.setSmall(b, domain.smallEnd(b) + (ib     * nb) / pb);
+                bx.setBig  (b, domain.smallEnd(b) + ((ib+1) * nb) / pb - 1);
+                bl.push_back(bx);
+            }
+        }
+        return BoxArray(bl);
+    }
+}
+
+FFTPoisson::FFTPoisson (const Geometry& geom)
+    : m_geom(geom),
+      m_domain(geom.Domain())
+{
+    BL_PROFILE("FFTPoisson::FFTPoisson()");
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    const Real* dx = geom.CellSize();
+
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+    {
+        m_ba[dir] = make_pencils(m_domain, dir, nprocs);
+
+        // One pencil per rank
+        Vector<int> pmap(m_ba[dir].size());
+        for (int i = 0; i < pmap.size(); ++i)
+            pmap[i] = i;
+        m_dm[dir].define(pmap);
+
+        m_data[dir].define(m_ba[dir], m_dm[dir], 2, 0);
+
+        const int n = m_domain.length(dir);
+        m_fft[dir].reset(new LineFFT(n));
+
+        m_lambda[dir].resize(n);
+        for (int k = 0; k < n; ++k)
+            m_lambda[dir][k] = (2.0 * std::cos(2.0 * M_PI * k / n) - 2.0) / (dx[dir] * dx[dir]);
+    }
+}
+
+FFTPoisson::~FFTPoisson () {}
+
+bool
+FFTPoisson::matches (const Geometry& geom) const
+{
+    if (geom.Domain() != m_domain) return false;
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+        if (geom.CellSize(dir) != m_geom.CellSize(dir)) return false;
+    return true;
+}
+
+void
+FFTPoisson::transform (int dir, bool forward)
+{
+    BL_PROFILE("FFTPoisson::transform()");
+
+    MultiFab& data = m_data[dir];
+    const LineFFT& fft = *m_fft[dir];
+    const int n = fft.size();
+
+    const int a = (dir + 1) % AMREX_SPACEDIM;
+    const int b = (dir + 2) % AMREX_SPACEDIM;
+
+    // One pencil per rank, so the threads share out its lines
+    for (MFIter mfi(data); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto u  = data.array(mfi);
+        const int na  = bx.length(a);
+        const int nb  = bx.length(b);
+        const IntVect lo = bx.smallEnd();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            Vector<Complex> line(n);
+            Vector<Complex> work(std::max(fft.work_size(), 1));
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (int l = 0; l < na*nb; ++l)
+            {
+                int iv[3] = {lo[0], lo[1], lo[2]};
+                iv[a] += l % na;
+                iv[b] += l / na;
+
+                for (int m = 0; m < n; ++m)
+                {
+                    iv[dir] = lo[dir] + m;
+                    line[m] = Complex(u(iv[0],iv[1],iv[2],0), u(iv[0],iv[1],iv[2],1));
+                }
+
+                if (forward)
+                    fft.forward(line.dataPtr(), work.dataPtr());
+                else
+                    fft.backward(line.dataPtr(), work.dataPtr());
+
+                for (int m = 0; m < n; ++m)
+                {
+                    iv[dir] = lo[dir] + m;
+                    u(iv[0],iv[1],iv[2],0) = line[m].real();
+                    u(iv[0],iv[1],iv[2],1) = line[m].imag();
+                }
+            }
+        }
+    }
+}
+
+void
+FFTPoisson::apply_green ()
+{
+    BL_PROFILE("FFTPoisson::apply_green()");
+
+    MultiFab& data = m_data[AMREX_SPACEDIM-1];
+    const Real ninv = 1.0 / m_domain.d_numPts();
+    const IntVect dlo = m_domain.smallEnd();
+
+    const Real* lx = m_lambda[0].dataPtr();
+    const Real* ly = m_lambda[1].dataPtr();
+    const Real* lz = m_lambda[2].dataPtr();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(data, true); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto u  = data.array(mfi);
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+
+        for (int k = lo.z; k <= hi.z; ++k)
+        {
+            for (int j = lo.y; j <= hi.y; ++j)
+            {
+                for (int i = lo.x; i <= hi.x; ++i)
+                {
+                    const Real lambda = lx[i-dlo[0]] + ly[j-dlo[1]] + lz[k-dlo[2]];
+
+                    // The mean (the only zero eigenvalue) is dropped; the
+                    // inverse transforms are normalized here
+                    const Real scale = (lambda == 0.0) ? 0.0 : ninv / lambda;
+                    u(i,j,k,0) *= scale;
+                    u(i,j,k,1) *= scale;
+                }
+            }
+        }
+    }
+}
+
+Real
+FFTPoisson::solve (MultiFab& phi, const MultiFab& rhs,
+                   const std::array<MultiFab*,AMREX_SPACEDIM>& grad_phi)
+{
+    BL_PROFILE("FFTPoisson::solve()");
+
+    BL_ASSERT(rhs.boxArray().numPts() == m_domain.numPts());
+
+    m_data[0].setVal(0.0);
+    m_data[0].ParallelCopy(rhs, 0, 0, 1);
+
+    transform(0, true);
+    m_data[1].ParallelCopy(m_data[0], 0, 0, 2);
+    transform(1, true);
+    m_data[2].ParallelCopy(m_data[1], 0, 0, 2);
+    transform(2, true);
+
+    apply_green();
+
+    transform(2, false);
+    m_data[1].ParallelCopy(m_data[2], 0, 0, 2);
+    transform(1, false);
+    m_data[0].ParallelCopy(m_data[1], 0, 0, 2);
+    transform(0, false);
+
+    phi.ParallelCopy(m_data[0], 0, 0, 1);
+    phi.FillBoundary(m_geom.periodicity());
+
+    const Real* dx = m_geom.CellSize();
+    const Real dx2inv[3] = {1.0/(dx[0]*dx[0]), 1.0/(dx[1]*dx[1]), 1.0/(dx[2]*dx[2])};
+
+    // Face-centred gradient, as MLMG::getGradSolution
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+    {
+        MultiFab& grad = *grad_phi[dir];
+        const Real dxinv = 1.0 / dx[dir];
+        const int di = (dir == 0), dj = (dir == 1), dk = (dir == 2);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(grad, true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto g  = grad.array(mfi);
+            const auto p  = phi.const_array(mfi);
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+
+            for (int k = lo.z; k <= hi.z; ++k)
+                for (int j = lo.y; j <= hi.y; ++j)
+                    for (int i = lo.x; i <= hi.x; ++i)
+                        g(i,j,k) = (p(i,j,k) - p(i-di,j-dj,k-dk)) * dxinv;
+        }
+    }
+
+    // Max norm of lap(phi) - rhs, less the mean of rhs the solve dropped
+    const Real rhs_mean = rhs.sum(0) / m_domain.d_numPts();
+    Real resnorm = 0.0;
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(max:resnorm)
+#endif
+    for (MFIter mfi(rhs, true); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto p  = phi.const_array(mfi);
+        const auto f  = rhs.const_array(mfi);
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+
+        for (int k = lo.z; k <= hi.z; ++k)
+            for (int j = lo.y; j <= hi.y; ++j)
+                for (int i = lo.x; i <= hi.x; ++i)
+                {
+                    const Real lap = (p(i-1,j,k) - 2.0*p(i,j,k) + p(i+1,j,k)) * dx2inv[0]
+                                   + (p(i,j-1,k) - 2.0*p(i,j,k) + p(i,j+1,k)) * dx2inv[1]
+                                   + (p(i,j,k-1) - 2.0*p(i,j,k) + p(i,j,k+1)) * dx2inv[2];
+                    resnorm = std::max(resnorm, std::abs(lap - (f(i,j,k) - rhs_mean)));
+                }
+    }
+    ParallelDescriptor::ReduceRealMax(resnorm);
+
+    return resnorm;
+}
@@ -2,6 +2,7 @@
 
 #include <AMReX_ParmParse.H>
 #include "Gravity.H"
+#include "FFTPoisson.H"
 #include "Nyx.H"
 #include <Gravity_F.H>
 #include <Nyx_F.H>
@@ -28,6 +29,9 @@ int  Gravity::dirichlet_bcs = 0;
 int  Gravity::mlmg_max_fmg_iter = 0;
 int  Gravity::mlmg_agglomeration = 0;
 int  Gravity::mlmg_consolidation = 0;
+int  Gravity::mlmg_reuse    = 1;
+int  Gravity::use_fft       = 0;
+int  Gravity::phi_extrapolate = 0;
 Real Gravity::sl_tol        = 1.e-12;
 Real Gravity::ml_tol        = 1.e-12;
 Real Gravity::delta_tol     = 1.e-12;
@@ -66,6 +70,9 @@ Gravity::Gravity (Amr*   Parent,
     grad_phi_curr(MAX_LEV),
     grad_phi_prev(MAX_LEV),
     phi_flux_reg(MAX_LEV),
+    phi_prev(MAX_LEV),
+    phi_prev_time(MAX_LEV),
+    phi_prev_a(MAX_LEV),
     grids(Parent->boxArray()),
     dmap(Parent->DistributionMap()),
     level_solver_resnorm(MAX_LEV),
@@ -80,6 +87,9 @@ Gravity::Gravity (Amr*   Parent,
 #else
      if(gravity_type == "PoissonGrav") make_mg_bc();
 #endif
+
+     if (use_fft && !parent->Geom(0).isAllPeriodic())
+         amrex::Abort("gravity_type = FFTGrav requires a fully periodic domain");
 }
 
 
@@ -98,17 +108,24 @@ Gravity::read_params ()
         ParmParse pp("gravity");
         pp.get("gravity_type", gravity_type);
 
+        // FFTGrav is PoissonGrav with the level 0 solves done by FFTPoisson
+        if (gravity_type == "FFTGrav")
+        {
+            gravity_type = "PoissonGrav";
+            use_fft = 1;
+        }
+
 #ifdef CGRAV
         if (gravity_type != "PoissonGrav" && gravity_type != "CompositeGrav" && gravity_type != "StaticGrav")
         {
             std::cout << "Sorry -- dont know this gravity type" << std::endl;
-            amrex::Abort("Options are PoissonGrav, CompositeGrav and StaticGrav");
+            amrex::Abort("Options are PoissonGrav, FFTGrav, CompositeGrav and StaticGrav");
         }
 #else
         if (gravity_type != "PoissonGrav")
         {
             std::cout << "Sorry -- dont know this gravity type" << std::endl;
-            amrex::Abort("Options are PoissonGrav");
+            amrex::Abort("Options are PoissonGrav and FFTGrav");
         }
 #endif
 
@@ -121,12 +138,19 @@ Gravity::read_params ()
         pp.query("mlmg_max_fmg_iter", mlmg_max_fmg_iter);
         pp.query("mlmg_agglomeration", mlmg_agglomeration);
         pp.query("mlmg_consolidation", mlmg_consolidation);
+        pp.query("mlmg_reuse", mlmg_reuse);
+        pp.query("phi_extrapolate", phi_extrapolate);
 
         // Allow run-time input of solver tolerances
         pp.query("ml_tol", ml_tol);
         pp.query("sl_tol", sl_tol);
         pp.query("delta_tol", delta_tol);
 
+#ifdef AMREX_USE_GPU
+        if (use_fft)
+            amrex::Error("gravity_type = FFTGrav is only supported in CPU builds");
+#endif
+
         Real Gconst;
         fort_get_grav_const(&Gconst);
         Ggravity = -4.0 * M_PI * Gconst;
@@ -244,6 +268,66 @@ Gravity::swap_time_levels (int level)
     }
 }
 
+void
+Gravity::make_new_phi_guess (int level,
+                             int finest_level)
+{
+    BL_PROFILE("Gravity::make_new_phi_guess()");
+
+    for (int lev = level; lev <= finest_level; lev++)
+    {
+        const StateData& phi_state = LevelData[lev]->get_state_data(PhiGrav_Type);
+        const MultiFab& phi_old = LevelData[lev]->get_old_data(PhiGrav_Type);
+        MultiFab&       phi_new = LevelData[lev]->get_new_data(PhiGrav_Type);
+
+        MultiFab::Copy(phi_new, phi_old, 0, 0, 1, 0);
+
+        if (!phi_extrapolate)
+            continue;
+
+        Nyx* cs = dynamic_cast<Nyx*>(LevelData[lev]);
+        BL_ASSERT(cs != 0);
+
+        const Real t_old = phi_state.prevTime();
+        const Real t_new = phi_state.curTime();
+        const Real a_old = cs->get_comoving_a(t_old);
+        const Real a_new = cs->get_comoving_a(t_new);
+
+        const Real eps = 1.e-12 * std::abs(t_new);
+        const bool have_prev = phi_prev[lev] &&
+                               phi_prev[lev]->boxArray() == grids[lev] &&
+                               phi_prev[lev]->DistributionMap() == dmap[lev];
+
+        if (have_prev && t_old - phi_prev_time[lev] > eps && t_new - t_old > eps)
+        {
+            //
+            // In linear theory phi (which carries the 1/a of the RHS) grows
+            // as D(a)/a, so we extrapolate phi a / D(a) linearly in time
+            // and scale it back with D/a at the new time
+            //
+            const Real s_prev = Nyx::get_growth_factor(phi_prev_a[lev]) / phi_prev_a[lev];
+            const Real s_old  = Nyx::get_growth_factor(a_old) / a_old;
+            const Real s_new  = Nyx::get_growth_factor(a_new) / a_new;
+
+            const Real w = (t_new - t_old) / (t_old - phi_prev_time[lev]);
+
+            if (verbose)
+                amrex::Print() << " ... extrapolating phi guess at level " << lev
+                               << " with weight " << w << '\n';
+
+            MultiFab::LinComb(phi_new, (1 + w) * s_new / s_old, phi_old, 0,
+                              -w * s_new / s_prev, *phi_prev[lev], 0, 0, 1, 0);
+        }
+
+        // Keep old phi for the guess of the next step
+        if (!have_prev)
+            phi_prev[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, 0));
+        MultiFab::Copy(*phi_prev[lev], phi_old, 0, 0, 1, 0);
+        phi_prev_time[lev] = t_old;
+        phi_prev_a[lev]    = a_old;
+    }
+}
+
 void
 Gravity::zero_phi_flux_reg (int level)
 {
@@ -1199,15 +1283,14 @@ Gravity::AddParticlesToRhs (int               level,
 
     amrex::Gpu::LaunchSafeGuard lsg(true);
 
-    // Use the same multifab for all particle types
-    MultiFab particle_mf(grids[level], dmap[level], 1, ngrow);
-
-    for (int i = 0; i < Nyx::theActiveParticles().size(); i++)
-      {
-        Nyx::theActiveParticles()[i]->AssignDensitySingleLevel(particle_mf, level);
-        amrex::Gpu::Device::streamSynchronize();
+    if (Nyx::theActiveParticles().size() > 0)
+    {
+        // All particle types deposit into the same multifab
+        MultiFab particle_mf(grids[level], dmap[level], 1, ngrow);
+        NyxParticleContainerBase::AssignTotalDensitySingleLevel(Nyx::theActiveParticles(), particle_mf,
+                                                                level, parent->Geom(level));
         MultiFab::Add(Rhs, particle_mf, 0, 0, 1, 0);
-      }
+    }
 
     amrex::Gpu::Device::streamSynchronize();
 
@@ -1219,28 +1302,27 @@ Gravity::AddParticlesToRhs(int base_level, int finest_level, int ngrow, const Ve
     BL_PROFILE("Gravity::AddParticlesToRhsML()");
 
     amrex::Gpu::LaunchSafeGuard lsg(true);
-    const int num_levels = finest_level - base_level + 1;
-    for (int i = 0; i < Nyx::theActiveParticles().size(); i++)
+
+    if (Nyx::theActiveParticles().size() > 0)
     {
+        const int num_levels = finest_level - base_level + 1;
+
+        // All particle types deposit into the same multifabs, which come back
+        // averaged down
         Vector<std::unique_ptr<MultiFab> > PartMF;
-        Nyx::theActiveParticles()[i]->AssignDensity(PartMF, base_level, 1, finest_level, ngrow);
+        NyxParticleContainerBase::AssignTotalDensity(Nyx::theActiveParticles(), PartMF, parent,
+                                                     base_level, finest_level, ngrow);
 #ifdef AMREX_DEBUG
         for (int lev = 0; lev < num_levels; lev++)
         {
             if (PartMF[lev]->contains_nan())
             {
-                std::cout << "Testing particle density of type " << i << " at level " << base_level+lev << std::endl;
+                std::cout << "Testing particle density at level " << base_level+lev << std::endl;
                 amrex::Abort("...PartMF has NaNs in Gravity::actual_multilevel_solve()");
             }
         }
 #endif
 
-        for (int lev = finest_level - 1 - base_level; lev >= 0; lev--)
-        {
-            amrex::average_down(*PartMF[lev+1], *PartMF[lev],
-                                 0, 1, parent->refRatio(lev+base_level));
-        }
-
         for (int lev = 0; lev < num_levels; lev++)
         {
             MultiFab::Add(*Rhs_particles[lev], *PartMF[lev], 0, 0, 1, 0);
@@ -1259,17 +1341,13 @@ Gravity::AddVirtualParticlesToRhs (int               level,
 
     amrex::Gpu::LaunchSafeGuard lsg(true);
 
-    if (level <  parent->finestLevel())
+    if (level <  parent->finestLevel() && Nyx::theVirtualParticles().size() > 0)
     {
         // If we have virtual particles, add their density to the single level solve
         MultiFab particle_mf(grids[level], dmap[level], 1, ngrow);
-
-        for (int i = 0; i < Nyx::theVirtualParticles().size(); i++)
-        {
-            particle_mf.setVal(0.);
-            Nyx::theVirtualParticles()[i]->AssignDensitySingleLevel(particle_mf, level, 1, 1);
-            MultiFab::Add(Rhs, particle_mf, 0, 0, 1, 0);
-        }
+        NyxParticleContainerBase::AssignTotalDensitySingleLevel(Nyx::theVirtualParticles(), particle_mf,
+                                                                level, parent->Geom(level), 1);
+        MultiFab::Add(Rhs, particle_mf, 0, 0, 1, 0);
     }
 
     amrex::Gpu::Device::streamSynchronize();
@@ -1280,18 +1358,16 @@ Gravity::AddVirtualParticlesToRhs(int finest_level, const Vector<MultiFab*>& Rhs
 {
     BL_PROFILE("Gravity::AddVirtualParticlesToRhsML()");
     amrex::Gpu::LaunchSafeGuard lsg(true);
-    if (finest_level < parent->finestLevel())
+    if (finest_level < parent->finestLevel() && Nyx::theVirtualParticles().size() > 0)
     {
         // Should only need ghost cells for virtual particles if they're near
         // the simulation boundary and even then only maybe
         MultiFab VirtPartMF(grids[finest_level], dmap[finest_level], 1, 1);
-        VirtPartMF.setVal(0.0);
+        NyxParticleContainerBase::AssignTotalDensitySingleLevel(Nyx::theVirtualParticles(), VirtPartMF,
+                                                                finest_level, parent->Geom(finest_level), 1);
 
-        for (int i = 0; i < Nyx::theGhostParticles().size(); i++)
-        {
-            Nyx::theVirtualParticles()[i]->AssignDensitySingleLevel(VirtPartMF, finest_level, 1, 1);
-            MultiFab::Add(*Rhs_particles[finest_level], VirtPartMF, 0, 0, 1, 0);
-        }
+        // Rhs_particles starts at the base level of the solve, so finest_level is its last entry
+        MultiFab::Add(*Rhs_particles.back(), VirtPartMF, 0, 0, 1, 0);
     }
     amrex::Gpu::Device::streamSynchronize();
 }
@@ -1304,17 +1380,13 @@ Gravity::AddGhostParticlesToRhs (int               level,
 
     amrex::Gpu::LaunchSafeGuard lsg(true);
 
-    if (level > 0)
+    if (level > 0 && Nyx::theGhostParticles().size() > 0)
     {
         // If we have ghost particles, add their density to the single level solve
         MultiFab ghost_mf(grids[level], dmap[level], 1, 1);
-
-        for (int i = 0; i < Nyx::theGhostParticles().size(); i++)
-        {
-            ghost_mf.setVal(0.);
-            Nyx::theGhostParticles()[i]->AssignDensitySingleLevel(ghost_mf, level, 1, -1);
-            MultiFab::Add(Rhs, ghost_mf, 0, 0, 1, 0);
-        }
+        NyxParticleContainerBase::AssignTotalDensitySingleLevel(Nyx::theGhostParticles(), ghost_mf,
+                                                                level, parent->Geom(level), -1);
+        MultiFab::Add(Rhs, ghost_mf, 0, 0, 1, 0);
     }
     amrex::Gpu::Device::streamSynchronize();
 }
@@ -1326,23 +1398,20 @@ Gravity::AddGhostParticlesToRhs(int level, const Vector<MultiFab*>& Rhs_particle
 
     amrex::Gpu::LaunchSafeGuard lsg(true);
 
-    if (level > 0)
+    if (level > 0 && Nyx::theGhostParticles().size() > 0)
     {
         // We require one ghost cell in GhostPartMF because that's how we handle
         // particles near fine-fine boundaries.  However we don't add any ghost
         // cells from GhostPartMF to the RHS.
         MultiFab GhostPartMF(grids[level], dmap[level], 1, 1);
-        GhostPartMF.setVal(0.0);
 
         // Get the Ghost particle mass function. Note that Ghost particles should
         // only affect the coarsest level so we use a single level solve.  We pass in
         // -1 for the particle_lvl_offset because that makes the particles the size
         // of the coarse, not fine, dx.
-        for (int i = 0; i < Nyx::theGhostParticles().size(); i++)
-        {
-            Nyx::theGhostParticles()[i]->AssignDensitySingleLevel(GhostPartMF, level, 1, -1);
-            MultiFab::Add(*Rhs_particles[0], GhostPartMF, 0, 0, 1, 0);
-        }
+        NyxParticleContainerBase::AssignTotalDensitySingleLevel(Nyx::theGhostParticles(), GhostPartMF,
+                                                                level, parent->Geom(level), -1);
+        MultiFab::Add(*Rhs_particles[0], GhostPartMF, 0, 0, 1, 0);
     }
     amrex::Gpu::Device::streamSynchronize();
 }
@@ -1439,6 +1508,10 @@ Gravity::solve_with_MLMG (int crse_level, int fine_level,
 {
     BL_PROFILE("Gravity::solve_with_MLMG");
 
+    // Level 0 on its own covers the periodic domain: one FFT solve
+    if (use_fft && crse_level == 0 && fine_level == 0)
+        return solve_with_FFT(*phi[0], *rhs[0], grad_phi[0]);
+
     const int nlevs = fine_level - crse_level + 1;
 
     Vector<Geometry> gmv;
@@ -1451,20 +1524,36 @@ Gravity::solve_with_MLMG (int crse_level, int fine_level,
         dmv.push_back(rhs[ilev]->DistributionMap());
     }
 
-    LPInfo info;
-    info.setAgglomeration(mlmg_agglomeration);
-    info.setConsolidation(mlmg_consolidation);
-    
-    if(mlmg_agglomeration)
-      info.setAgglomerationGridSize(16);
+    // Reuse the operator and solver of the last solve over these levels if
+    // their grids have not changed since
+    MLMGSolver one_off;
+    MLMGSolver& solver = mlmg_reuse ? mlmg_cache[std::make_pair(crse_level, fine_level)] : one_off;
+
+    if (!solver.mlpoisson || solver.ba != bav || solver.dm != dmv)
+    {
+        LPInfo info;
+        info.setAgglomeration(mlmg_agglomeration);
+        info.setConsolidation(mlmg_consolidation);
 
-    if(mlmg_consolidation)
-      info.setConsolidationGridSize(16);
+        if(mlmg_agglomeration)
+          info.setAgglomerationGridSize(16);
 
-    MLPoisson mlpoisson(gmv, bav, dmv, info);
+        if(mlmg_consolidation)
+          info.setConsolidationGridSize(16);
 
-    // BC
-    mlpoisson.setDomainBC(mlmg_lobc, mlmg_hibc);
+        // The solver refers to the operator, so it goes first
+        solver.mlmg.reset();
+        solver.mlpoisson.reset(new MLPoisson(gmv, bav, dmv, info));
+
+        // BC
+        solver.mlpoisson->setDomainBC(mlmg_lobc, mlmg_hibc);
+
+        solver.mlmg.reset(new MLMG(*solver.mlpoisson));
+        solver.ba = bav;
+        solver.dm = dmv;
+    }
+
+    MLPoisson& mlpoisson = *solver.mlpoisson;
 
     if (mlpoisson.needsCoarseDataForBC())
     {
@@ -1476,7 +1565,7 @@ Gravity::solve_with_MLMG (int crse_level, int fine_level,
         mlpoisson.setLevelBC(ilev, phi[ilev]);
     }
 
-    MLMG mlmg(mlpoisson);
+    MLMG& mlmg = *solver.mlmg;
     mlmg.setVerbose(verbose);
     if (crse_level == 0) {
         mlmg.setMaxFmgIter(mlmg_max_fmg_iter);
@@ -1495,6 +1584,31 @@ Gravity::solve_with_MLMG (int crse_level, int fine_level,
     return final_resnorm;
 }
 
+Real
+Gravity::solve_with_FFT (MultiFab& phi, const MultiFab& rhs,
+                         const std::array<MultiFab*,AMREX_SPACEDIM>& grad_phi)
+{
+    BL_PROFILE("Gravity::solve_with_FFT");
+
+    // The pencils do not depend on the level 0 grids, so regrids keep them
+    const Geometry& geom = parent->Geom(0);
+    if (!fft_poisson || !fft_poisson->matches(geom))
+        fft_poisson.reset(new FFTPoisson(geom));
+
+    const Real resnorm = fft_poisson->solve(phi, rhs, grad_phi);
+
+    if (verbose)
+        amrex::Print() << "Gravity ... FFT solve at level 0, residual " << resnorm << '\n';
+
+    return resnorm;
+}
+
+void
+Gravity::clear_mlmg_cache ()
+{
+    mlmg_cache.clear();
+}
+
 void
 Gravity::set_boundary(BndryData& bd, MultiFab& rhs, const Real* dx)
 {
@@ -35,7 +35,7 @@ static int check_retval(void *flagvalue, const char *funcname, int opt);
 int Nyx::integrate_state_box
   (amrex::MultiFab &S_old,
    amrex::MultiFab &D_old,
-   const Real& a, const Real& delta_time)
+   const Real& a, const Real& delta_time, Real* cfl_dt)
 {
     // time = starting time in the simulation
   realtype reltol, abstol, t, tout, umax;
@@ -49,8 +49,8 @@ int Nyx::integrate_state_box
   //  LS = NULL;
   cvode_mem = NULL;
 
-  reltol = 1e-4;  /* Set the tolerances */
-  abstol = 1e-4;
+  reltol = sundials_rtol;  /* Set the tolerances */
+  abstol = sundials_atol;
 
   int count =0;
   fort_ode_eos_setup(a,delta_time);
@@ -60,6 +60,18 @@ int Nyx::integrate_state_box
   else
   S_old.Subtract(S_old,S_old,Eint,Eden,1,0);
 
+  MultiFab& hc_cost = get_heat_cool_cost();
+
+  // Minimum of hydro_cell_dt, taken over each tile right after its final EOS pass
+  ReduceOps<ReduceOpMin> reduce_op;
+  ReduceData<Real> reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+
+  const auto dx = geom.CellSizeArray();
+  const Real sound_speed_factor = std::sqrt(gamma*(gamma-1));
+  const Real small_dens_in = small_dens;
+  const int  max_temp_dt_in = max_temp_dt;
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -224,6 +236,15 @@ int Nyx::integrate_state_box
               PrintOutput(tout, umax, nst);
             }
       }
+      {
+        // Record the work for load_balance_wgt_strategy 3
+        long int nfe_tile = 0, nst_tile = 0;
+        CVodeGetNumRhsEvals(cvode_mem, &nfe_tile);
+        CVodeGetNumSteps(cvode_mem, &nst_tile);
+        const Box cbx = tbx & mfi.validbox();
+        hc_cost[mfi].plus<RunOn::Device>(Real(nfe_tile), cbx, 0, 1);
+        hc_cost[mfi].plus<RunOn::Device>(Real(nst_tile), cbx, 1, 1);
+      }
 
       int one_in=1;
       for(int i=0;i<neq;i++)
@@ -249,6 +270,17 @@ int Nyx::integrate_state_box
     
       S_old[mfi].copyFromMem<RunOn::Device>(tbx,Eint,1,dptr);
       S_old[mfi].addFromMem<RunOn::Device>(tbx,Eden,1,dptr);
+
+      if (cfl_dt)
+      {
+          const auto u4 = S_old.const_array(mfi);
+          reduce_op.eval(tbx, reduce_data,
+          [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+          {
+              return hydro_cell_dt(i, j, k, u4, dx, sound_speed_factor,
+                                   small_dens_in, max_temp_dt_in);
+          });
+      }
       if(amrex::Verbose()>2||false)
         {
           amrex::Print()<<S_old[mfi].min<RunOn::Device>(Eint)<<"at index"<<S_old[mfi].minIndex<RunOn::Device>(Eint)<<std::endl;
@@ -266,6 +298,12 @@ int Nyx::integrate_state_box
             amrex::Abort("state has NaNs after the first strang call");
 #endif
     }
+
+    if (cfl_dt)
+    {
+        ReduceTuple hv = reduce_data.value();
+        *cfl_dt = amrex::get<0>(hv);
+    }
     return 0;
 }
 
@@ -287,8 +325,8 @@ int Nyx::integrate_state_grownbox
   //  LS = NULL;
   cvode_mem = NULL;
   
-  reltol = 1e-4;  /* Set the tolerances */
-  abstol = 1e-4;
+  reltol = sundials_rtol;  /* Set the tolerances */
+  abstol = sundials_atol;
 
   fort_ode_eos_setup(a,delta_time);
 
@@ -296,6 +334,7 @@ int Nyx::integrate_state_grownbox
     S_old.Subtract(S_old,S_old,Eint,Eden,1,S_old.nGrow());
   else
     S_old.Subtract(S_old,S_old,Eint,Eden,1,0);
+  MultiFab& hc_cost = get_heat_cool_cost();
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -458,6 +497,15 @@ int Nyx::integrate_state_grownbox
           PrintOutput(tout, umax, nst);
         }
       }
+      {
+        // Record the work for load_balance_wgt_strategy 3
+        long int nfe_tile = 0, nst_tile = 0;
+        CVodeGetNumRhsEvals(cvode_mem, &nfe_tile);
+        CVodeGetNumSteps(cvode_mem, &nst_tile);
+        const Box cbx = tbx & mfi.validbox();
+        hc_cost[mfi].plus<RunOn::Device>(Real(nfe_tile), cbx, 0, 1);
+        hc_cost[mfi].plus<RunOn::Device>(Real(nst_tile), cbx, 1, 1);
+      }
 #ifdef AMREX_USE_CUDA
       amrex::Gpu::Device::streamSynchronize();
       N_VCopyFromDevice_Cuda(u);
@@ -597,12 +645,7 @@ static int f(realtype t, N_Vector u, N_Vector udot, void* user_data)
   fprintf(stdout,"\nrparh[1]=%g \n\n",rpar[1]);
   fprintf(stdout,"\nrparh[2]=%g \n\n",rpar[2]);
   fprintf(stdout,"\nrparh[3]=%g \n\n",rpar[3]);*/
-  for(int tid=0;tid<neq;tid++)
-    {
-      //    fprintf(stdout,"\nrpar[4*tid+0]=%g\n",rpar[4*tid]);
-    RhsFnReal(t,&(u_ptr[tid]),&(udot_ptr[tid]),&(rpar[4*tid]),1);
-    //    fprintf(stdout,"\nafter rpar[4*tid+0]=%g\n",rpar[4*tid]);
-    }
+  RhsFnRealBatch(t,u_ptr,udot_ptr,rpar,neq);
   /*      fprintf(stdout,"\nafter rparh[0]=%g \n\n",rpar[0]);
   fprintf(stdout,"\nafter rparh[1]=%g \n\n",rpar[1]);
   fprintf(stdout,"\nafter rparh[2]=%g \n\n",rpar[2]);
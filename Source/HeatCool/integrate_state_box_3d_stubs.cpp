@@ -57,6 +57,10 @@ int Nyx::integrate_state_grownvec
   return 0;
 }
 
+void Nyx::clear_cvode_workspace_pool()
+{
+}
+
 int Nyx::integrate_state_cell
   (amrex::MultiFab &S_old,
    amrex::MultiFab &D_old,
@@ -35,19 +35,33 @@ static int check_retval(void *flagvalue, const char *funcname, int opt);
 int Nyx::integrate_state_cell
   (amrex::MultiFab &S_old,
    amrex::MultiFab &D_old,
-   const Real& a, const Real& delta_time)
+   const Real& a, const Real& delta_time, Real* cfl_dt)
 {
     // time = starting time in the simulation
   realtype reltol, abstol;
     
-  reltol = 1e-4;  /* Set the tolerances */
-  abstol = 1e-4;
+  reltol = sundials_rtol;  /* Set the tolerances */
+  abstol = sundials_atol;
+
+  MultiFab& hc_cost = get_heat_cool_cost();
+
+  // Minimum of hydro_cell_dt, taken over each tile right after its final EOS pass
+  ReduceOps<ReduceOpMin> reduce_op;
+  ReduceData<Real> reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+
+  const auto dx = geom.CellSizeArray();
+  const Real sound_speed_factor = std::sqrt(gamma*(gamma-1));
+  const Real small_dens_in = small_dens;
+  const int  max_temp_dt_in = max_temp_dt;
 
   #ifdef _OPENMP
   #pragma omp parallel if (Gpu::notInLaunchRegion())
   #endif
   for ( MFIter mfi(S_old, TilingIfNotGPU()); mfi.isValid(); ++mfi )
     {
+      const Box& vbx = mfi.validbox();
+      Array4<Real> const& cost4 = hc_cost.array(mfi);
       fort_ode_eos_setup(a,delta_time);
       //check that copy contructor vs create constructor works??
       const Box& tbx = mfi.tilebox();
@@ -111,6 +125,16 @@ int Nyx::integrate_state_cell
               BL_PROFILE_VAR("Nyx::strang_second_cvode",cvode_timer2);
               flag = CVode(cvode_mem, delta_time, u, &t, CV_NORMAL);
               BL_PROFILE_VAR_STOP(cvode_timer2);
+
+              if (vbx.contains(IntVect(AMREX_D_DECL(i,j,k))))
+              {
+                // CVodeReInit resets the counters, so these are this cell's work
+                long int nfe_cell = 0, nst_cell = 0;
+                CVodeGetNumRhsEvals(cvode_mem, &nfe_cell);
+                CVodeGetNumSteps(cvode_mem, &nst_cell);
+                cost4(i,j,k,0) += nfe_cell;
+                cost4(i,j,k,1) += nst_cell;
+              }
               
               AMREX_LAUNCH_DEVICE_LAMBDA(neq,i,
                                          {
@@ -129,6 +153,16 @@ int Nyx::integrate_state_cell
       N_VDestroy(Data);          /* Free the userdata vector */
       CVodeFree(&cvode_mem);  /* Free the integrator memory */
 
+      if (cfl_dt)
+      {
+          const auto u4 = S_old.const_array(mfi);
+          reduce_op.eval(tbx, reduce_data,
+          [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+          {
+              return hydro_cell_dt(i, j, k, u4, dx, sound_speed_factor,
+                                   small_dens_in, max_temp_dt_in);
+          });
+      }
     }
   #ifdef AMREX_DEBUG
   #ifdef AMREX_DEBUG
@@ -137,6 +171,11 @@ int Nyx::integrate_state_cell
   #endif
 #endif
 
+    if (cfl_dt)
+    {
+        ReduceTuple hv = reduce_data.value();
+        *cfl_dt = amrex::get<0>(hv);
+    }
     return 0;
 }
 
@@ -152,16 +191,19 @@ int Nyx::integrate_state_growncell
   int iout, flag;
   bool do_tiling=false;    
 
-  reltol = 1e-4;  /* Set the tolerances */
-  abstol = 1e-4;
+  reltol = sundials_rtol;  /* Set the tolerances */
+  abstol = sundials_atol;
 
   fort_ode_eos_setup(a,delta_time);
   amrex::Gpu::setLaunchRegion(false);
+  MultiFab& hc_cost = get_heat_cool_cost();
   #ifdef _OPENMP
   #pragma omp parallel if (Gpu::notInLaunchRegion())
   #endif
   for ( MFIter mfi(S_old, TilingIfNotGPU()); mfi.isValid(); ++mfi )
     {
+      const Box& vbx = mfi.validbox();
+      Array4<Real> const& cost4 = hc_cost.array(mfi);
   fort_ode_eos_setup(a,delta_time);
       //check that copy contructor vs create constructor works??
       const Box& tbx = mfi.growntilebox();
@@ -227,6 +269,16 @@ int Nyx::integrate_state_growncell
               BL_PROFILE_VAR("Nyx::strang_first_cvode",cvode_timer1);
               flag = CVode(cvode_mem, delta_time, u, &t, CV_NORMAL);
               BL_PROFILE_VAR_STOP(cvode_timer1);
+
+              if (vbx.contains(IntVect(AMREX_D_DECL(i,j,k))))
+              {
+                // CVodeReInit resets the counters, so these are this cell's work
+                long int nfe_cell = 0, nst_cell = 0;
+                CVodeGetNumRhsEvals(cvode_mem, &nfe_cell);
+                CVodeGetNumSteps(cvode_mem, &nst_cell);
+                cost4(i,j,k,0) += nfe_cell;
+                cost4(i,j,k,1) += nst_cell;
+              }
               
               AMREX_LAUNCH_DEVICE_LAMBDA(neq,i,
                                          {
@@ -1,5 +1,9 @@
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
+#include <map>
+#include <numeric>
+#include <unordered_set>
 
 #include <AMReX_ParmParse.H>
 #include <AMReX_Geometry.H>
@@ -23,6 +27,9 @@
 #ifdef AMREX_USE_CUDA
 #include <nvector/nvector_cuda.h>
 #endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #define PATCH 1
 //#define MAKE_MANAGED 1
 using namespace amrex;
@@ -37,7 +44,10 @@ static void PrintOutput(realtype t, realtype umax, long int nst);
 /* Private function to check function return values */
 static int check_retval(void *flagvalue, const char *funcname, int opt);
 
-amrex::Vector<void*> ptr_lst;
+/* Number of cells per OpenMP work item in the CPU RHS */
+static constexpr int rhs_chunk_size = 256;
+
+std::unordered_set<void*> ptr_lst;
 //static amrex::Arena* Managed_Arena;
 
 void* sunalloc(size_t mem_size)
@@ -45,39 +55,359 @@ void* sunalloc(size_t mem_size)
   amrex::MultiFab::updateMemUsage ("Sunalloc", mem_size, nullptr);
   amrex::MultiFab::updateMemUsage ("All", mem_size, nullptr);
   void * ptr = (void*) The_Arena()->alloc(mem_size);
-  ptr_lst.push_back(ptr);
+#ifdef _OPENMP
+#pragma omp critical (sunalloc_ptr_lst)
+#endif
+  ptr_lst.insert(ptr);
   return ptr;
 }
 
 void sunfree(void* ptr)
 {
   size_t mem_size = dynamic_cast<CArena*>(The_Arena())->sizeOf(ptr);
-  ptr_lst.erase(std::remove_if(ptr_lst.begin(), ptr_lst.end(), [ptr](void* x) { return x == ptr; }));
+#ifdef _OPENMP
+#pragma omp critical (sunalloc_ptr_lst)
+#endif
+  ptr_lst.erase(ptr);
   The_Arena()->free(ptr);
   amrex::MultiFab::updateMemUsage ("Sunalloc", -mem_size, nullptr);
   amrex::MultiFab::updateMemUsage ("All", -mem_size, nullptr);
 }
 
+/* SUNDIALS vectors and CVODE memory for one tile size, reused with CVodeReInit */
+struct CVodeWorkspace
+{
+  long int neq = 0;
+  N_Vector u = NULL;
+  N_Vector e_orig = NULL;
+  N_Vector Data = NULL;
+  N_Vector abstol_vec = NULL;
+  N_Vector constrain = NULL;
+  double *dptr = NULL, *eptr = NULL, *rparh = NULL, *abstol_ptr = NULL;
+  void *cvode_mem = NULL;
+  // Scratch for the explicit update of non-stiff cells (heat_cool_classify)
+  amrex::Vector<Real> u0, udot0, rpar0, u1, udot1, rpar1;
+  amrex::Vector<long int> expl_idx, stiff_idx;
+  // Cells not skipped as quiescent, and the skipped ones (heat_cool_lazy)
+  amrex::Vector<long int> cand_idx;
+  amrex::Vector<char> lazy;
+};
+
+/* One pool per OpenMP thread, keyed on the number of cells in the tile */
+static amrex::Vector<std::map<long int, CVodeWorkspace> >& cvode_pool()
+{
+#ifdef _OPENMP
+  static amrex::Vector<std::map<long int, CVodeWorkspace> > pool(omp_get_max_threads());
+#else
+  static amrex::Vector<std::map<long int, CVodeWorkspace> > pool(1);
+#endif
+  return pool;
+}
+
+/* Workspaces for the compacted stiff cells of a tile, keyed on the padded batch size */
+static amrex::Vector<std::map<long int, CVodeWorkspace> >& cvode_stiff_pool()
+{
+#ifdef _OPENMP
+  static amrex::Vector<std::map<long int, CVodeWorkspace> > pool(omp_get_max_threads());
+#else
+  static amrex::Vector<std::map<long int, CVodeWorkspace> > pool(1);
+#endif
+  return pool;
+}
+
+static void cvode_workspace_alloc(CVodeWorkspace& ws, long int neq, int sundials_alloc_type)
+{
+  ws.neq = neq;
+#ifdef AMREX_USE_CUDA
+                        cudaStream_t currentStream = amrex::Gpu::Device::cudaStream();  
+                        if(sundials_alloc_type%2==0)
+                        {
+                          if(sundials_alloc_type==0)
+                            ws.u = N_VMakeWithManagedAllocator_Cuda(neq,sunalloc,sunfree);  /* Allocate u vector */
+                          else
+                            ws.u = N_VNewManaged_Cuda(neq);  /* Allocate u vector */
+
+                          ws.dptr=N_VGetDeviceArrayPointer_Cuda(ws.u);
+
+                          if(sundials_alloc_type==0)
+                            ws.e_orig = N_VMakeWithManagedAllocator_Cuda(neq,sunalloc,sunfree);  /* Allocate u vector */
+                          else
+                            ws.e_orig = N_VNewManaged_Cuda(neq);  /* Allocate u vector */
+
+                          ws.eptr=N_VGetDeviceArrayPointer_Cuda(ws.e_orig);
+                          N_VSetCudaStream_Cuda(ws.e_orig, &currentStream);
+                          N_VSetCudaStream_Cuda(ws.u, &currentStream);
+
+                          if(sundials_alloc_type==0)
+                            ws.Data = N_VMakeWithManagedAllocator_Cuda(4*neq,sunalloc,sunfree);  // Allocate u vector 
+                          else
+                            ws.Data = N_VNewManaged_Cuda(4*neq);  /* Allocate u vector */
+
+                          ws.rparh = N_VGetDeviceArrayPointer_Cuda(ws.Data);
+                          N_VSetCudaStream_Cuda(ws.Data, &currentStream);
+
+                          if(sundials_alloc_type==0)
+                            ws.abstol_vec = N_VMakeWithManagedAllocator_Cuda(neq,sunalloc,sunfree);  
+                          else
+                            ws.abstol_vec = N_VNewManaged_Cuda(neq);  /* Allocate u vector */
+
+                          ws.abstol_ptr = N_VGetDeviceArrayPointer_Cuda(ws.abstol_vec);
+                          N_VSetCudaStream_Cuda(ws.abstol_vec,&currentStream);
+                          amrex::Gpu::Device::streamSynchronize();
+                        }
+                        else
+                        {
+                          ws.dptr=(double*) The_Managed_Arena()->alloc(neq*sizeof(double));
+                          ws.u = N_VMakeManaged_Cuda(neq,ws.dptr);  /* Allocate u vector */
+                          ws.eptr= (double*) The_Managed_Arena()->alloc(neq*sizeof(double));
+                          ws.e_orig = N_VMakeManaged_Cuda(neq,ws.eptr);  /* Allocate u vector */
+                          N_VSetCudaStream_Cuda(ws.e_orig, &currentStream);
+                          N_VSetCudaStream_Cuda(ws.u, &currentStream);
+
+                          ws.rparh = (double*) The_Managed_Arena()->alloc(4*neq*sizeof(double));
+                          ws.Data = N_VMakeManaged_Cuda(4*neq,ws.rparh);  // Allocate u vector 
+                          N_VSetCudaStream_Cuda(ws.Data, &currentStream);
+
+                          ws.abstol_ptr = (double*) The_Managed_Arena()->alloc(neq*sizeof(double));
+                          ws.abstol_vec = N_VMakeManaged_Cuda(neq,ws.abstol_ptr);
+                          N_VSetCudaStream_Cuda(ws.abstol_vec,&currentStream);
+                          amrex::Gpu::streamSynchronize();
+                        }
+
+#else
+                        // Each tile is integrated by a single thread, see heat_cool_tile_tasks
+                        ws.u = N_VNew_Serial(neq);  /* Allocate u vector */
+                        ws.e_orig = N_VNew_Serial(neq);  /* Allocate u vector */
+                        ws.eptr=N_VGetArrayPointer_Serial(ws.e_orig);
+                        ws.dptr=N_VGetArrayPointer_Serial(ws.u);
+
+                        ws.Data = N_VNew_Serial(4*neq);  // Allocate u vector 
+                        N_VConst(0.0,ws.Data);
+                        ws.rparh=N_VGetArrayPointer_Serial(ws.Data);
+                        ws.abstol_vec = N_VNew_Serial(neq);
+                        ws.abstol_ptr=N_VGetArrayPointer_Serial(ws.abstol_vec);
+#endif
+}
+
+static void cvode_workspace_free(CVodeWorkspace& ws, int sundials_alloc_type)
+{
+#ifdef AMREX_USE_CUDA
+      if(sundials_alloc_type%2!=0)
+      {
+        The_Managed_Arena()->free(ws.dptr);
+        The_Managed_Arena()->free(ws.eptr);
+        The_Managed_Arena()->free(ws.rparh);
+        The_Managed_Arena()->free(ws.abstol_ptr);
+      }
+#endif
+      N_VDestroy(ws.u);          /* Free the u vector */
+      N_VDestroy(ws.e_orig);          /* Free the e_orig vector */
+      if(ws.constrain != NULL)
+        N_VDestroy(ws.constrain);          /* Free the constrain vector */
+      N_VDestroy(ws.abstol_vec);          /* Free the u vector */
+      N_VDestroy(ws.Data);          /* Free the userdata vector */
+      if(ws.cvode_mem != NULL)
+        CVodeFree(&ws.cvode_mem);  /* Free the integrator memory */
+}
+
+/* Drop all pooled workspaces; called after regrid and at cleanup so tile sizes that no longer occur are released */
+void Nyx::clear_cvode_workspace_pool()
+{
+  for (auto& thread_pool : cvode_pool())
+    {
+      for (auto& kv : thread_pool)
+        cvode_workspace_free(kv.second, sundials_alloc_type);
+      thread_pool.clear();
+    }
+  for (auto& thread_pool : cvode_stiff_pool())
+    {
+      for (auto& kv : thread_pool)
+        cvode_workspace_free(kv.second, sundials_alloc_type);
+      thread_pool.clear();
+    }
+}
+
+#ifndef AMREX_USE_CUDA
+/* Evaluate the heating/cooling RHS over n cells, one OpenMP work item per chunk */
+static void rhs_chunked(Real t, Real* u_ptr, Real* udot_ptr, Real* rpar, long int n)
+{
+  // Hand each thread a contiguous chunk; RhsFnRealBatch evaluates it in SIMD-width lanes
+  // Tiles already run one per thread; only a call from serial code opens a region here
+  const long int nchunks = (n + rhs_chunk_size - 1) / rhs_chunk_size;
+#ifdef _OPENMP
+#pragma omp parallel for if(!omp_in_parallel())
+#endif
+  for(long int ichunk=0;ichunk<nchunks;ichunk++)
+    {
+      const long int offset = ichunk*rhs_chunk_size;
+      const int nlen = std::min((long int) rhs_chunk_size, n-offset);
+      RhsFnRealBatch(t,&(u_ptr[offset]),&(udot_ptr[offset]),&(rpar[4*offset]),nlen);
+    }
+}
+
+/*
+  Cells with dt/t_cool below tol are candidates for a two-stage explicit (Heun)
+  update in place. The update is kept only if its local error estimate,
+  half the change in slope times dt, is within the tolerances CVODE would
+  use for the cell (rtol*|e| + ws.abstol_ptr); otherwise the cell is treated
+  as stiff after all. Indices of the stiff cells are left in ws.stiff_idx.
+*/
+static long int heat_cool_explicit_update(CVodeWorkspace& ws, Real delta_time, Real tol, Real rtol)
+{
+  // Candidates come in ws.cand_idx; the cells left for CVODE go out in ws.stiff_idx
+  const long int ncand = ws.cand_idx.size();
+  double* dptr  = ws.dptr;
+  double* rparh = ws.rparh;
+
+  ws.u0.resize(ncand);
+  ws.udot0.resize(ncand);
+  ws.rpar0.resize(4*ncand);
+  ws.expl_idx.clear();
+  ws.stiff_idx.clear();
+
+  for(long int n=0;n<ncand;n++)
+    {
+      const long int idx = ws.cand_idx[n];
+      ws.u0[n] = dptr[idx];
+      for(int m=0;m<4;m++)
+        ws.rpar0[4*n+m] = rparh[4*idx+m];
+    }
+
+  // Slope at the start of the step gives the cooling time e/|de/dt|
+  rhs_chunked(0.0, ws.u0.dataPtr(), ws.udot0.dataPtr(), ws.rpar0.dataPtr(), ncand);
+
+  for(long int n=0;n<ncand;n++)
+    {
+      const long int idx = ws.cand_idx[n];
+      // Keep the T and ne the RHS solved for as the guess for what follows
+      rparh[4*idx+0] = ws.rpar0[4*n+0];
+      rparh[4*idx+1] = ws.rpar0[4*n+1];
+      if(std::abs(ws.udot0[n])*delta_time <= tol*ws.u0[n])
+        ws.expl_idx.push_back(n);
+      else
+        ws.stiff_idx.push_back(idx);
+    }
+
+  const long int nexpl = ws.expl_idx.size();
+  if(nexpl > 0)
+    {
+      ws.u1.resize(nexpl);
+      ws.udot1.resize(nexpl);
+      ws.rpar1.resize(4*nexpl);
+      for(long int e=0;e<nexpl;e++)
+        {
+          const long int n = ws.expl_idx[e];
+          ws.u1[e] = ws.u0[n] + delta_time*ws.udot0[n];
+          for(int m=0;m<4;m++)
+            ws.rpar1[4*e+m] = ws.rpar0[4*n+m];
+        }
+
+      rhs_chunked(delta_time, ws.u1.dataPtr(), ws.udot1.dataPtr(), ws.rpar1.dataPtr(), nexpl);
+
+      for(long int e=0;e<nexpl;e++)
+        {
+          const long int n = ws.expl_idx[e];
+          const long int idx = ws.cand_idx[n];
+          if(0.5*std::abs(ws.udot1[e]-ws.udot0[n])*delta_time <=
+             rtol*std::abs(ws.u0[n]) + ws.abstol_ptr[idx])
+            {
+              dptr[idx] += 0.5*delta_time*(ws.udot0[n]+ws.udot1[e]);
+              rparh[4*idx+0] = ws.rpar1[4*e+0];
+              rparh[4*idx+1] = ws.rpar1[4*e+1];
+            }
+          else
+            ws.stiff_idx.push_back(idx);
+        }
+      std::sort(ws.stiff_idx.begin(), ws.stiff_idx.end());
+    }
+
+  return ws.stiff_idx.size();
+}
+#endif
+
+
+#ifdef _OPENMP
+/*
+  Call body(box index, tile box) once per tile, each call an OpenMP task so
+  idle threads steal tiles that are still queued. Tiles are queued most expensive
+  first by the work recorded in the cost map, so dense or shocked tiles start early
+  instead of serializing the end of the level.
+*/
+template <class F>
+static void heat_cool_tile_tasks(MultiFab& S, MultiFab& cost, bool grown, F&& body)
+{
+  amrex::Vector<int> fab_index;
+  amrex::Vector<Box> tiles;
+  amrex::Vector<Real> tile_cost;
+
+  for ( MFIter mfi(S, true); mfi.isValid(); ++mfi )
+    {
+      // The global box index, which is what FabArray::array(int) takes
+      fab_index.push_back(mfi.index());
+      tiles.push_back(grown ? mfi.growntilebox() : mfi.tilebox());
+      tile_cost.push_back(cost[mfi].sum(mfi.tilebox(), 0));
+    }
+
+  amrex::Vector<int> order(tiles.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&] (int l, int r) { return tile_cost[l] > tile_cost[r]; });
+
+#pragma omp parallel
+#pragma omp single nowait
+  for (int n : order)
+    {
+#pragma omp task firstprivate(n)
+      body(fab_index[n], tiles[n]);
+    }
+}
+#endif
 
 int Nyx::integrate_state_vec
   (amrex::MultiFab &S_old,
    amrex::MultiFab &D_old,
-   const Real& a, const Real& delta_time)
+   const Real& a, const Real& delta_time, Real* cfl_dt)
 {
     // time = starting time in the simulation
 
   amrex::Gpu::LaunchSafeGuard lsg(true);
   fort_ode_eos_setup(a,delta_time);
   long int store_steps=new_max_sundials_steps;
-  
-  //#ifdef _OPENMP
-  //#pragma omp parallel if (Gpu::notInLaunchRegion())
-  //#endif
+  MultiFab& cost = get_heat_cool_cost();
+  MultiFab& lazy = get_heat_cool_lazy_state();
+  AMREX_ASSERT(cost.boxArray() == S_old.boxArray());
+  // The tile tasks index cost and lazy by the global box index of S_old
+  AMREX_ASSERT(cost.DistributionMap() == S_old.DistributionMap());
+  AMREX_ASSERT(lazy.boxArray() == S_old.boxArray() && lazy.DistributionMap() == S_old.DistributionMap());
+
+  // Minimum of hydro_cell_dt, taken over each tile right after its final EOS pass
+  ReduceOps<ReduceOpMin> reduce_op;
+  ReduceData<Real> reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+
+  const auto dx = geom.CellSizeArray();
+  const Real sound_speed_factor = std::sqrt(gamma*(gamma-1));
+  const Real small_dens_in = small_dens;
+  const int  max_temp_dt_in = max_temp_dt;
+
 #ifdef _OPENMP
-  for ( MFIter mfi(S_old, false); mfi.isValid(); ++mfi )
+  heat_cool_tile_tasks(S_old, cost, false, [&] (int gi, const Box& tbx)
+  {
+      integrate_state_vec_mfin(S_old.array(gi),D_old.array(gi),tbx,a,delta_time,store_steps,new_max_sundials_steps,cost.array(gi),lazy.array(gi));
+
+      if (cfl_dt)
+      {
+          const auto u = S_old.const_array(gi);
+          reduce_op.eval(tbx, reduce_data,
+          [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+          {
+              return hydro_cell_dt(i, j, k, u, dx, sound_speed_factor,
+                                   small_dens_in, max_temp_dt_in);
+          });
+      }
+  });
 #else
   for ( MFIter mfi(S_old, TilingIfNotGPU()); mfi.isValid(); ++mfi )
-#endif
     {
 
       //check that copy contructor vs create constructor works??
@@ -88,8 +418,26 @@ int Nyx::integrate_state_vec
       Array4<Real> const& state4 = S_old.array(mfi);
       Array4<Real> const& diag_eos4 = D_old.array(mfi);
 
-      integrate_state_vec_mfin(state4,diag_eos4,tbx,a,delta_time,store_steps,new_max_sundials_steps);
-}
+      integrate_state_vec_mfin(state4,diag_eos4,tbx,a,delta_time,store_steps,new_max_sundials_steps,cost.array(mfi),lazy.array(mfi));
+
+      if (cfl_dt)
+      {
+          const auto u = S_old.const_array(mfi);
+          reduce_op.eval(tbx, reduce_data,
+          [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+          {
+              return hydro_cell_dt(i, j, k, u, dx, sound_speed_factor,
+                                   small_dens_in, max_temp_dt_in);
+          });
+      }
+    }
+#endif
+
+  if (cfl_dt)
+  {
+      ReduceTuple hv = reduce_data.value();
+      *cfl_dt = amrex::get<0>(hv);
+  }
       return 0;
 }
 
@@ -98,14 +446,16 @@ int Nyx::integrate_state_vec_mfin
    amrex::Array4<Real> const& diag_eos4,
    const Box& tbx,
    const Real& a, const Real& delta_time,
-   long int& old_max_steps, long int& new_max_steps)
+   long int& old_max_steps, long int& new_max_steps,
+   amrex::Array4<Real> const& cost4,
+   amrex::Array4<Real> const& lazy4)
 {
 
   realtype reltol, abstol;
   int flag;
     
-  reltol = 1e-4;  /* Set the tolerances */
-  abstol = 1e-4;
+  reltol = sundials_rtol;  /* Set the tolerances */
+  abstol = sundials_atol;
 
   int one_in = 1;
   
@@ -113,124 +463,32 @@ int Nyx::integrate_state_vec_mfin
       const auto len = amrex::length(tbx);  // length of box
       const auto lo  = amrex::lbound(tbx);  // lower bound of box
 
-      N_Vector u;
-      N_Vector e_orig;
-      N_Vector Data;
-      N_Vector abstol_vec;
-
-      void *cvode_mem;
-      double *dptr, *eptr, *rpar, *rparh, *abstol_ptr;
       realtype t=0.0;
-                                
-      u = NULL;
-      e_orig = NULL;
-      Data = NULL;
-      abstol_vec = NULL;
-      cvode_mem = NULL;
 
       long int neq = len.x*len.y*len.z;
       amrex::Gpu::streamSynchronize();
       int loop = 1;
 
-#ifdef AMREX_USE_CUDA
-                        cudaStream_t currentStream = amrex::Gpu::Device::cudaStream();  
-                        if(sundials_alloc_type%2==0)
-                        {
-                          if(sundials_alloc_type==0)
-                            u = N_VMakeWithManagedAllocator_Cuda(neq,sunalloc,sunfree);  /* Allocate u vector */
-                          else
-                            u = N_VNewManaged_Cuda(neq);  /* Allocate u vector */
-
-                          dptr=N_VGetDeviceArrayPointer_Cuda(u);
-
-                          if(sundials_alloc_type==0)
-                            e_orig = N_VMakeWithManagedAllocator_Cuda(neq,sunalloc,sunfree);  /* Allocate u vector */
-                          else
-                            e_orig = N_VNewManaged_Cuda(neq);  /* Allocate u vector */
-
-                          eptr=N_VGetDeviceArrayPointer_Cuda(e_orig);
-                          N_VSetCudaStream_Cuda(e_orig, &currentStream);
-                          N_VSetCudaStream_Cuda(u, &currentStream);
-
-                          if(sundials_alloc_type==0)
-                            Data = N_VMakeWithManagedAllocator_Cuda(4*neq,sunalloc,sunfree);  // Allocate u vector 
-                          else
-                            Data = N_VNewManaged_Cuda(4*neq);  /* Allocate u vector */
-
-                          rparh = N_VGetDeviceArrayPointer_Cuda(Data);
-                          N_VSetCudaStream_Cuda(Data, &currentStream);
-                          // shouldn't need to initialize 
-                          //N_VConst(0.0,Data);
-
-                          if(sundials_alloc_type==0)
-                            abstol_vec = N_VMakeWithManagedAllocator_Cuda(neq,sunalloc,sunfree);  
-                          else
-                            abstol_vec = N_VNewManaged_Cuda(neq);  /* Allocate u vector */
-
-                          abstol_ptr = N_VGetDeviceArrayPointer_Cuda(abstol_vec);
-                          N_VSetCudaStream_Cuda(abstol_vec,&currentStream);
-                          amrex::Gpu::Device::streamSynchronize();
-                        }
-                        else
-                        {
-                          dptr=(double*) The_Managed_Arena()->alloc(neq*sizeof(double));
-                          u = N_VMakeManaged_Cuda(neq,dptr);  /* Allocate u vector */
-                          eptr= (double*) The_Managed_Arena()->alloc(neq*sizeof(double));
-                          e_orig = N_VMakeManaged_Cuda(neq,eptr);  /* Allocate u vector */
-                          N_VSetCudaStream_Cuda(e_orig, &currentStream);
-                          N_VSetCudaStream_Cuda(u, &currentStream);
-
-                          rparh = (double*) The_Managed_Arena()->alloc(4*neq*sizeof(double));
-                          Data = N_VMakeManaged_Cuda(4*neq,rparh);  // Allocate u vector 
-                          N_VSetCudaStream_Cuda(Data, &currentStream);
-                          // shouldn't need to initialize 
-                          //N_VConst(0.0,Data);
-
-                          abstol_ptr = (double*) The_Managed_Arena()->alloc(neq*sizeof(double));
-                          abstol_vec = N_VMakeManaged_Cuda(neq,abstol_ptr);
-                          N_VSetCudaStream_Cuda(abstol_vec,&currentStream);
-                          amrex::Gpu::streamSynchronize();
-                        }
-
-#else
+      // Reuse this thread's vectors and solver memory for tiles of this size
 #ifdef _OPENMP
-                        int nthreads=omp_get_max_threads();
-                        u = N_VNew_OpenMP(neq,nthreads);  /* Allocate u vector */
-                        e_orig = N_VNew_OpenMP(neq,nthreads);  /* Allocate u vector */
-                        eptr=N_VGetArrayPointer_Serial(e_orig);
-                        dptr=N_VGetArrayPointer_OpenMP(u);
-
-                        Data = N_VNew_OpenMP(4*neq,nthreads);  // Allocate u vector 
-                        N_VConst(0.0,Data);
-                        rparh=N_VGetArrayPointer_OpenMP(Data);
-                        abstol_vec = N_VNew_OpenMP(neq,nthreads);
-                        abstol_ptr=N_VGetArrayPointer_OpenMP(abstol_vec);
+      std::map<long int, CVodeWorkspace>& thread_pool = cvode_pool()[omp_get_thread_num()];
 #else
-                        u = N_VNew_Serial(neq);  /* Allocate u vector */
-                        e_orig = N_VNew_Serial(neq);  /* Allocate u vector */
-                        eptr=N_VGetArrayPointer_Serial(e_orig);
-                        dptr=N_VGetArrayPointer_Serial(u);
-
-                        Data = N_VNew_Serial(4*neq);  // Allocate u vector 
-                        N_VConst(0.0,Data);
-                        rparh=N_VGetArrayPointer_Serial(Data);
-                        abstol_vec = N_VNew_Serial(neq);
-                        abstol_ptr=N_VGetArrayPointer_Serial(abstol_vec);
-#endif
+      std::map<long int, CVodeWorkspace>& thread_pool = cvode_pool()[0];
 #endif
+      CVodeWorkspace& ws = thread_pool[neq];
+      if (ws.u == NULL)
+        cvode_workspace_alloc(ws, neq, sundials_alloc_type);
 
-#ifdef _OPENMP
-      const Dim3 hi = amrex::ubound(tbx);
+      double* dptr       = ws.dptr;
+      double* eptr       = ws.eptr;
+      double* rparh      = ws.rparh;
+      double* abstol_ptr = ws.abstol_ptr;
+
+      // Tiles may run on any thread; set this thread's EOS state for the step
+      fort_ode_eos_setup(a,delta_time);
 
-#pragma omp parallel for collapse(3)
-      for (int k = lo.z; k <= hi.z; ++k) {
-        for (int j = lo.y; j <= hi.y; ++j) {
-            for (int i = lo.x; i <= hi.x; ++i) {
-              fort_ode_eos_setup(a,delta_time);
-#else
                                 AMREX_PARALLEL_FOR_3D ( tbx, i,j,k,
                                 {                                 
-#endif
                                   int idx = i+j*len.x+k*len.x*len.y-(lo.x+lo.y*len.x+lo.z*len.x*len.y);
                                   dptr[idx]=state4(i,j,k,Eint)/state4(i,j,k,Density);
                                   eptr[idx]=state4(i,j,k,Eint)/state4(i,j,k,Density);
@@ -240,62 +498,146 @@ int Nyx::integrate_state_vec_mfin
                                   rparh[4*idx+3]=1/a-1;    //    rpar(4)=z_vode
                                   abstol_ptr[idx]= state4(i,j,k,Eint)/state4(i,j,k,Density)*abstol;
                                   //                            }
-#ifdef _OPENMP
-                                }
-                                }
-                                }
-#pragma omp barrier
-#else
                                 });
       amrex::Gpu::Device::streamSynchronize();
+
+      // Optionally integrate only the stiff cells, compacted into their own batch
+      CVodeWorkspace* wc = &ws;
+      long int nstiff = neq;
+      long int nfe_tile = 0, nst_tile = 0;
+#ifndef AMREX_USE_CUDA
+      const Dim3 lbeg = lazy4.begin;
+      const Dim3 lend = lazy4.end;
+      if(heat_cool_classify || heat_cool_lazy)
+      {
+        ws.cand_idx.clear();
+        if(heat_cool_lazy)
+        {
+          // Quiescent cells follow their last integrated rate; every heat_cool_lazy_refresh
+          // half-steps they are integrated again, and so is any cell whose rho or e has
+          // moved off the path that rate predicts (hydro, sources) by more than
+          // heat_cool_lazy_tol. Ghost cells of a grown tile always are.
+          ws.lazy.assign(neq, 0);
+          for (int k = lo.z; k < lo.z+len.z; ++k)
+            for (int j = lo.y; j < lo.y+len.y; ++j)
+              for (int i = lo.x; i < lo.x+len.x; ++i)
+              {
+                const long int idx = (i-lo.x) + (j-lo.y)*len.x + (k-lo.z)*len.x*len.y;
+                if (i >= lbeg.x && i < lend.x && j >= lbeg.y && j < lend.y && k >= lbeg.z && k < lend.z &&
+                    lazy4(i,j,k,1) < heat_cool_lazy_refresh &&
+                    std::abs(lazy4(i,j,k,0))*delta_time <= heat_cool_lazy_tol &&
+                    std::abs(state4(i,j,k,Density) - lazy4(i,j,k,2)) <= heat_cool_lazy_tol*lazy4(i,j,k,2) &&
+                    std::abs(eptr[idx] - lazy4(i,j,k,3)) <= heat_cool_lazy_tol*lazy4(i,j,k,3))
+                {
+                  dptr[idx] *= 1.0 + lazy4(i,j,k,0)*delta_time;
+                  ws.lazy[idx] = 1;
+                }
+                else
+                  ws.cand_idx.push_back(idx);
+              }
+        }
+        else
+        {
+          ws.cand_idx.resize(neq);
+          std::iota(ws.cand_idx.begin(), ws.cand_idx.end(), 0);
+        }
+
+        if(heat_cool_classify)
+          nstiff = heat_cool_explicit_update(ws, delta_time, heat_cool_explicit_tol, reltol);
+        else
+        {
+          ws.stiff_idx = ws.cand_idx;
+          nstiff = ws.stiff_idx.size();
+        }
+
+        if(nstiff > 0 && nstiff < neq)
+        {
+          // Pad to a multiple of neq/8 so a tile size needs at most nine stiff workspaces
+          const long int granule = (neq+7)/8;
+          const long int npad = std::min(neq, ((nstiff+granule-1)/granule)*granule);
+#ifdef _OPENMP
+          std::map<long int, CVodeWorkspace>& stiff_pool = cvode_stiff_pool()[omp_get_thread_num()];
+#else
+          std::map<long int, CVodeWorkspace>& stiff_pool = cvode_stiff_pool()[0];
+#endif
+          wc = &stiff_pool[npad];
+          if (wc->u == NULL)
+            cvode_workspace_alloc(*wc, npad, sundials_alloc_type);
+
+          // Padding repeats the last stiff cell
+          for(long int n=0;n<npad;n++)
+          {
+            const long int idx = ws.stiff_idx[std::min(n,nstiff-1)];
+            wc->dptr[n] = dptr[idx];
+            wc->eptr[n] = eptr[idx];
+            wc->abstol_ptr[n] = abstol_ptr[idx];
+            for(int m=0;m<4;m++)
+              wc->rparh[4*n+m] = rparh[4*idx+m];
+          }
+        }
+      }
 #endif
 
+                                if(nstiff > 0)
+                                {
+                                if(wc->cvode_mem == NULL)
+                                {
 #ifdef CV_NEWTON
-                                cvode_mem = CVodeCreate(CV_BDF, CV_NEWTON);
+                                  wc->cvode_mem = CVodeCreate(CV_BDF, CV_NEWTON);
 #else
-                                cvode_mem = CVodeCreate(CV_BDF);
+                                  wc->cvode_mem = CVodeCreate(CV_BDF);
 #endif
-                                flag = CVodeInit(cvode_mem, f, t, u);
-
-                                N_VScale(abstol,u,abstol_vec);
-                                //                              N_VConst(N_VMin(abstol_vec),abstol_vec);
-
-                                flag = CVodeSVtolerances(cvode_mem, reltol, abstol_vec);
-
-                                //                              flag = CVodeSStolerances(cvode_mem, reltol, dptr[0]*abstol);
-                                flag = CVDiag(cvode_mem);
+                                  flag = CVodeInit(wc->cvode_mem, f, t, wc->u);
 
-                                CVodeSetMaxNumSteps(cvode_mem,2000);
+                                  flag = CVDiag(wc->cvode_mem);
 
-                                if(use_typical_steps)
-                                    CVodeSetMaxStep(cvode_mem,delta_time/(old_max_steps));
+                                  CVodeSetMaxNumSteps(wc->cvode_mem,2000);
 
-                                N_Vector constrain;
-                                if(use_sundials_constraint)
+                                  if(use_sundials_constraint)
                                   {
-                                    constrain=N_VClone(u);
-                                    N_VConst(2,constrain);            
-                                    flag =CVodeSetConstraints(cvode_mem,constrain);
+                                    wc->constrain=N_VClone(wc->u);
+                                    N_VConst(2,wc->constrain);
+                                    flag =CVodeSetConstraints(wc->cvode_mem,wc->constrain);
                                   }
 
 #ifdef SUNDIALS_VERSION_MAJOR
 #if SUNDIALS_VERSION_MAJOR >= 5
 #if SUNDIALS_VERSION_MINOR >= 3
-                                if(use_sundials_fused)
-                                {
-                                     flag = CVodeSetUseIntegratorFusedKernels(cvode_mem, SUNTRUE);
-                                }
+                                  if(use_sundials_fused)
+                                  {
+                                    flag = CVodeSetUseIntegratorFusedKernels(wc->cvode_mem, SUNTRUE);
+                                  }
 #endif
 #endif
 #endif
-                                CVodeSetUserData(cvode_mem, &Data);
+                                  CVodeSetUserData(wc->cvode_mem, &wc->Data);
+                                }
+                                else
+                                {
+                                  flag = CVodeReInit(wc->cvode_mem, t, wc->u);
+                                }
+                                void *cvode_mem = wc->cvode_mem;
+
+                                N_VScale(abstol,wc->u,wc->abstol_vec);
+                                //                              N_VConst(N_VMin(abstol_vec),abstol_vec);
+
+                                flag = CVodeSVtolerances(cvode_mem, reltol, wc->abstol_vec);
+
+                                if(use_typical_steps)
+                                    CVodeSetMaxStep(cvode_mem,delta_time/(old_max_steps));
+
                                 //                              CVodeSetMaxStep(cvode_mem, delta_time/10);
                                 //                              BL_PROFILE_VAR("Nyx::strang_second_cvode",cvode_timer2);
-                                flag = CVode(cvode_mem, delta_time, u, &t, CV_NORMAL);
+                                flag = CVode(cvode_mem, delta_time, wc->u, &t, CV_NORMAL);
+                                CVodeGetNumRhsEvals(cvode_mem, &nfe_tile);
+                                CVodeGetNumSteps(cvode_mem, &nst_tile);
                                 if(use_typical_steps)
                                   {
                                     long int nst=0;
                                     flag = CVodeGetNumSteps(cvode_mem, &nst);
+#ifdef _OPENMP
+#pragma omp critical (heat_cool_max_steps)
+#endif
                                     new_max_steps=std::max(nst,new_max_steps);
                                   }
                                 //                              amrex::Gpu::Device::streamSynchronize();
@@ -305,15 +647,68 @@ int Nyx::integrate_state_vec_mfin
                                 PrintFinalStats(cvode_mem);
 #endif
 
-#ifdef _OPENMP
-#pragma omp parallel for collapse(3)
-      for (int k = lo.z; k <= hi.z; ++k) {
-        for (int j = lo.y; j <= hi.y; ++j) {
-            for (int i = lo.x; i <= hi.x; ++i) {
-#else
+                                // Scatter the stiff cells back into the tile
+                                if(wc != &ws)
+                                {
+                                  for(long int n=0;n<nstiff;n++)
+                                  {
+                                    const long int idx = ws.stiff_idx[n];
+                                    dptr[idx] = wc->dptr[n];
+                                    rparh[4*idx+0] = wc->rparh[4*n+0];
+                                    rparh[4*idx+1] = wc->rparh[4*n+1];
+                                  }
+                                }
+                                }
+
+      // Record the work per cell for load_balance_wgt_strategy 3; ghost cells of a grown tile are skipped
+      {
+        const Dim3 cbeg = cost4.begin;
+        const Dim3 cend = cost4.end;
+#ifndef AMREX_USE_CUDA
+        if(heat_cool_classify || heat_cool_lazy)
+        {
+          // Candidates paid for the explicit attempt, stiff cells also for their CVODE batch;
+          // quiescent cells cost nothing
+          if(heat_cool_classify)
+            for(long int idx : ws.cand_idx)
+            {
+              const int i = lo.x + idx%len.x;
+              const int j = lo.y + (idx/len.x)%len.y;
+              const int k = lo.z + idx/(len.x*len.y);
+              if (i >= cbeg.x && i < cend.x && j >= cbeg.y && j < cend.y && k >= cbeg.z && k < cend.z)
+                cost4(i,j,k,0) += 2.0;
+            }
+          for(long int n=0;n<nstiff;n++)
+          {
+            const long int idx = ws.stiff_idx[n];
+            const int i = lo.x + idx%len.x;
+            const int j = lo.y + (idx/len.x)%len.y;
+            const int k = lo.z + idx/(len.x*len.y);
+            if (i >= cbeg.x && i < cend.x && j >= cbeg.y && j < cend.y && k >= cbeg.z && k < cend.z)
+            {
+              cost4(i,j,k,0) += nfe_tile;
+              cost4(i,j,k,1) += nst_tile;
+            }
+          }
+        }
+        else
+#endif
+        {
+          const Real rhs_evals = nfe_tile;
+          const Real steps = nst_tile;
+          AMREX_PARALLEL_FOR_3D ( tbx, i,j,k,
+          {
+            if (i >= cbeg.x && i < cend.x && j >= cbeg.y && j < cend.y && k >= cbeg.z && k < cend.z)
+            {
+              cost4(i,j,k,0) += rhs_evals;
+              cost4(i,j,k,1) += steps;
+            }
+          });
+        }
+      }
+
                                 AMREX_PARALLEL_FOR_3D ( tbx, i,j,k,
                                 {                                 
-#endif
                                   int  idx= i+j*len.x+k*len.x*len.y-(lo.x+lo.y*len.x+lo.z*len.x*len.y);
                                 //                              for (int i= 0;i < neq; ++i) {
                                   fort_ode_eos_finalize(&(dptr[idx*loop]), &(rparh[4*idx*loop]), one_in);
@@ -324,36 +719,37 @@ int Nyx::integrate_state_vec_mfin
                                   state4(i,j,k,Eden)  += state4(i,j,k,Density) * (dptr[idx*loop]-eptr[idx]);
                                   //                            }
                                 //PrintFinalStats(cvode_mem);
-#ifdef _OPENMP
-                                }
-                                }
-                                }
-#pragma omp barrier
-#else
                                 });
       amrex::Gpu::Device::streamSynchronize();
-#endif
 
-
-#ifdef AMREX_USE_CUDA
-      if(sundials_alloc_type%2!=0)
+#ifndef AMREX_USE_CUDA
+      // Remember each integrated cell's relative rate, rho and new e for the quiescent
+      // test next half-step; a lazy cell's e follows the rate it used
+      if(heat_cool_lazy)
       {
-        The_Managed_Arena()->free(dptr);
-        The_Managed_Arena()->free(eptr);
-        if(use_sundials_constraint)
-          The_Managed_Arena()->free(constrain);
-        The_Managed_Arena()->free(rparh);
-        The_Managed_Arena()->free(abstol_ptr);
+        for (int k = std::max(lo.z,lbeg.z); k < std::min(lo.z+len.z,lend.z); ++k)
+          for (int j = std::max(lo.y,lbeg.y); j < std::min(lo.y+len.y,lend.y); ++j)
+            for (int i = std::max(lo.x,lbeg.x); i < std::min(lo.x+len.x,lend.x); ++i)
+            {
+              const long int idx = (i-lo.x) + (j-lo.y)*len.x + (k-lo.z)*len.x*len.y;
+              if(ws.lazy[idx])
+              {
+                lazy4(i,j,k,1) += 1.0;
+                lazy4(i,j,k,3) *= 1.0 + lazy4(i,j,k,0)*delta_time;
+              }
+              else
+              {
+                lazy4(i,j,k,0) = (dptr[idx]-eptr[idx]) / (eptr[idx]*delta_time);
+                lazy4(i,j,k,1) = 0.0;
+                lazy4(i,j,k,2) = state4(i,j,k,Density);
+                lazy4(i,j,k,3) = dptr[idx];
+              }
+            }
       }
 #endif
 
-                                N_VDestroy(u);          /* Free the u vector */
-                                N_VDestroy(e_orig);          /* Free the e_orig vector */
-                                if(use_sundials_constraint)
-                                  N_VDestroy(constrain);          /* Free the constrain vector */
-                                N_VDestroy(abstol_vec);          /* Free the u vector */
-                                N_VDestroy(Data);          /* Free the userdata vector */
-                                CVodeFree(&cvode_mem);  /* Free the integrator memory */
+
+      // ws stays in the pool; see Nyx::clear_cvode_workspace_pool
                               //);
                                 /*                          }
                         
@@ -371,17 +767,22 @@ int Nyx::integrate_state_grownvec
   fort_ode_eos_setup(a,delta_time);
   amrex::Gpu::LaunchSafeGuard lsg(true);
   long int store_steps=old_max_sundials_steps;
+  MultiFab& cost = get_heat_cool_cost();
+  MultiFab& lazy = get_heat_cool_lazy_state();
+  AMREX_ASSERT(cost.boxArray() == S_old.boxArray());
+  // The tile tasks index cost and lazy by the global box index of S_old
+  AMREX_ASSERT(cost.DistributionMap() == S_old.DistributionMap());
+  AMREX_ASSERT(lazy.boxArray() == S_old.boxArray() && lazy.DistributionMap() == S_old.DistributionMap());
   
   const Real prev_time     = state[State_Type].prevTime();
   
-  //#ifdef _OPENMP
-  //#pragma omp parallel if (Gpu::notInLaunchRegion())
-  //#endif
 #ifdef _OPENMP
-  for ( MFIter mfi(S_old, false); mfi.isValid(); ++mfi )
+  heat_cool_tile_tasks(S_old, cost, true, [&] (int gi, const Box& tbx)
+  {
+      integrate_state_vec_mfin(S_old.array(gi),D_old.array(gi),tbx,a,delta_time,store_steps,old_max_sundials_steps,cost.array(gi),lazy.array(gi));
+  });
 #else
   for ( MFIter mfi(S_old, TilingIfNotGPU()); mfi.isValid(); ++mfi )
-#endif
     {
 
       //check that copy contructor vs create constructor works??
@@ -393,8 +794,9 @@ int Nyx::integrate_state_grownvec
       Array4<Real> const& state4 = S_old.array(mfi);
       Array4<Real> const& diag_eos4 = D_old.array(mfi);
 
-      integrate_state_vec_mfin(state4,diag_eos4,tbx,a,delta_time,store_steps,old_max_sundials_steps);
+      integrate_state_vec_mfin(state4,diag_eos4,tbx,a,delta_time,store_steps,old_max_sundials_steps,cost.array(mfi),lazy.array(mfi));
     }
+#endif
 
     return 0;
 }
@@ -433,11 +835,7 @@ static int f(realtype t, N_Vector u, N_Vector udot, void* user_data)
   int neq=N_VGetLength_Serial(udot);
   double*  rpar=N_VGetArrayPointer_Serial(*(static_cast<N_Vector*>(user_data)));
 
-  #pragma omp parallel for
-  for(int tid=0;tid<neq;tid++)
-    {
-      RhsFnReal(t,&(u_ptr[tid]),&(udot_ptr[tid]),&(rpar[4*tid]),1);
-    }
+  rhs_chunked(t,u_ptr,udot_ptr,rpar,neq);
 
   return 0;
 }
@@ -0,0 +1,243 @@
+#include "BoundaryFluxes.H"
+
+using namespace amrex;
+
+namespace
+{
+    // dst = src (or dst += weight*src) on the part of dst inside box nbx
+    void
+    copy_faces (FArrayBox& dst_fab, const FArrayBox& src_fab, const Box& nbx, int ncomp,
+                Real weight, bool accumulate)
+    {
+        const Box ov = nbx & dst_fab.box();
+        if (!ov.ok()) return;
+
+        Array4<Real> const dst = dst_fab.array();
+        Array4<Real const> const src = src_fab.const_array();
+
+        if (accumulate)
+        {
+            AMREX_HOST_DEVICE_FOR_4D(ov, ncomp, i, j, k, n,
+            {
+                dst(i,j,k,n) += weight*src(i,j,k,n);
+            });
+        }
+        else if (weight == 1.0)
+        {
+            AMREX_HOST_DEVICE_FOR_4D(ov, ncomp, i, j, k, n,
+            {
+                dst(i,j,k,n) = src(i,j,k,n);
+            });
+        }
+        else
+        {
+            AMREX_HOST_DEVICE_FOR_4D(ov, ncomp, i, j, k, n,
+            {
+                dst(i,j,k,n) = weight*src(i,j,k,n);
+            });
+        }
+    }
+}
+
+void
+BoundaryFluxes::define (const BoxArray& grids, const DistributionMapping& dmap,
+                        int ncomp, bool fine_add,
+                        const BoxArray* fine_grids, const IntVect& fine_ratio)
+{
+    BL_PROFILE("BoundaryFluxes::define()");
+
+    m_ncomp     = ncomp;
+    m_fine_add  = fine_add;
+    m_crse_init = fine_grids != nullptr;
+
+    if (m_fine_add)
+    {
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+        {
+            Vector<Box> lo(grids.size()), hi(grids.size());
+            for (int g = 0; g < grids.size(); ++g)
+            {
+                lo[g] = amrex::bdryLo(grids[g], dir);
+                hi[g] = amrex::bdryHi(grids[g], dir);
+            }
+            m_plane[dir][0].define(BoxArray(lo.data(), lo.size()), dmap, ncomp, 0);
+            m_plane[dir][1].define(BoxArray(hi.data(), hi.size()), dmap, ncomp, 0);
+        }
+    }
+
+    if (m_crse_init)
+    {
+        const BoxArray cfine = amrex::coarsen(*fine_grids, fine_ratio);
+        const int myproc = ParallelDescriptor::MyProc();
+
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+        {
+            const BoxArray egrids = amrex::convert(grids, IntVect::TheDimensionVector(dir));
+
+            // One box per (grid, face plane): the bounding box of the parts of
+            // the finer grids' boundaries on that plane of the grid. Keeping a
+            // single box per plane means each face is added to the register
+            // once per grid holding it, as it is with the full edge MultiFab.
+            std::map<std::pair<int,int>, Box> faces;
+
+            for (int b = 0; b < cfine.size(); ++b)
+            {
+                for (const Box& plane : {amrex::bdryLo(cfine[b], dir), amrex::bdryHi(cfine[b], dir)})
+                {
+                    for (const auto& is : egrids.intersections(plane))
+                    {
+                        const auto key = std::make_pair(is.first, plane.smallEnd(dir));
+                        auto it = faces.find(key);
+                        if (it == faces.end()) {
+                            faces.emplace(key, is.second);
+                        } else {
+                            it->second.minBox(is.second);
+                        }
+                    }
+                }
+            }
+
+            if (faces.empty()) continue;
+
+            Vector<Box> boxes;
+            Vector<int> pmap;
+            for (const auto& f : faces)
+            {
+                const int g = f.first.first;
+                if (dmap[g] == myproc) {
+                    m_crse_boxes[dir][g].push_back(boxes.size());
+                }
+                boxes.push_back(f.second);
+                pmap.push_back(dmap[g]);
+            }
+
+            m_crse[dir].define(BoxArray(boxes.data(), boxes.size()),
+                               DistributionMapping(std::move(pmap)), ncomp, 0);
+        }
+    }
+}
+
+void
+BoundaryFluxes::store (const MFIter& mfi, int dir, const FArrayBox& flux,
+                       Real weight, bool accumulate)
+{
+    store(mfi, mfi.tilebox(), dir, flux, weight, accumulate);
+}
+
+void
+BoundaryFluxes::store (const MFIter& mfi, const Box& bx, int dir,
+                       const FArrayBox& flux, Real weight, bool accumulate)
+{
+    const Box nbx = mfi.nodaltilebox(dir) & amrex::surroundingNodes(bx, dir);
+
+    if (m_fine_add)
+    {
+        copy_faces(m_plane[dir][0][mfi], flux, nbx, m_ncomp, weight, accumulate);
+        copy_faces(m_plane[dir][1][mfi], flux, nbx, m_ncomp, weight, accumulate);
+    }
+
+    if (m_crse_init)
+    {
+        const auto it = m_crse_boxes[dir].find(mfi.index());
+        if (it != m_crse_boxes[dir].end())
+        {
+            for (int c : it->second) {
+                copy_faces(m_crse[dir][c], flux, nbx, m_ncomp, weight, accumulate);
+            }
+        }
+    }
+}
+
+bool
+BoundaryFluxes::stores (const MFIter& mfi) const
+{
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+    {
+        const Box& nbx = mfi.nodaltilebox(dir);
+
+        if (m_fine_add)
+        {
+            if (nbx.intersects(m_plane[dir][0][mfi].box()) ||
+                nbx.intersects(m_plane[dir][1][mfi].box())) return true;
+        }
+
+        if (m_crse_init)
+        {
+            const auto it = m_crse_boxes[dir].find(mfi.index());
+            if (it != m_crse_boxes[dir].end())
+            {
+                for (int c : it->second) {
+                    if (nbx.intersects(m_crse[dir][c].box())) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void
+BoundaryFluxes::add_to_registers (FluxRegister* current, FluxRegister* fine)
+{
+    BL_PROFILE("BoundaryFluxes::add_to_registers()");
+
+    if (current && m_fine_add)
+    {
+        const IntVect ratio = current->refRatio();
+        const int rx = ratio[0], ry = ratio[1], rz = ratio[2];
+        const int ncomp = m_ncomp;
+
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                FabSet& reg = (*current)[Orientation(dir, side == 0 ? Orientation::low
+                                                                    : Orientation::high)];
+
+                // Sum the fine faces over each coarse face, in the order
+                // FluxRegister::FineAdd does
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+                for (MFIter mfi(m_plane[dir][side]); mfi.isValid(); ++mfi)
+                {
+                    const Box& cbx = reg[mfi].box();
+                    Array4<Real> const r = reg[mfi].array();
+                    Array4<Real const> const f = m_plane[dir][side].const_array(mfi);
+
+                    AMREX_HOST_DEVICE_FOR_4D(cbx, ncomp, i, j, k, n,
+                    {
+                        if (dir == 0) {
+                            for (int ko = 0; ko < rz; ++ko) {
+                                for (int jo = 0; jo < ry; ++jo) {
+                                    r(i,j,k,n) += f(i*rx, j*ry+jo, k*rz+ko, n);
+                                }
+                            }
+                        } else if (dir == 1) {
+                            for (int ko = 0; ko < rz; ++ko) {
+                                for (int io = 0; io < rx; ++io) {
+                                    r(i,j,k,n) += f(i*rx+io, j*ry, k*rz+ko, n);
+                                }
+                            }
+                        } else {
+                            for (int jo = 0; jo < ry; ++jo) {
+                                for (int io = 0; io < rx; ++io) {
+                                    r(i,j,k,n) += f(i*rx+io, j*ry+jo, k*rz, n);
+                                }
+                            }
+                        }
+                    });
+                }
+            }
+        }
+    }
+
+    if (fine && m_crse_init)
+    {
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+        {
+            if (m_crse[dir].size() > 0) {
+                fine->CrseInit(m_crse[dir], dir, 0, 0, m_ncomp, -1., FluxRegister::ADD);
+            }
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#include <HydroScratch.H>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+namespace {
+    // Start every view on its own 64-byte line
+    constexpr std::size_t align_reals = 64 / sizeof(Real);
+
+    Vector<HydroScratch>& scratch_pool ()
+    {
+#ifdef _OPENMP
+        static Vector<HydroScratch> pool(omp_get_max_threads());
+#else
+        static Vector<HydroScratch> pool(1);
+#endif
+        return pool;
+    }
+}
+
+HydroScratch&
+HydroScratch::get ()
+{
+#ifdef _OPENMP
+    return scratch_pool()[omp_get_thread_num()];
+#else
+    return scratch_pool()[0];
+#endif
+}
+
+void
+HydroScratch::clear_all ()
+{
+    for (HydroScratch& s : scratch_pool())
+    {
+        s.free_blocks();
+        s.m_elixirs.clear();
+    }
+}
+
+void
+HydroScratch::alloc (FArrayBox& fab, const Box& box, int ncomp)
+{
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion())
+    {
+        fab.resize(box, ncomp);
+        m_elixirs[&fab] = fab.elixir();
+        return;
+    }
+#endif
+
+    const std::size_t n = ((box.numPts()*ncomp + align_reals - 1) / align_reals) * align_reals;
+    m_need += n;
+
+    Real* p;
+    if (m_top + n <= m_size)
+    {
+        p = m_base + m_top;
+        m_top += n;
+    }
+    else
+    {
+        p = static_cast<Real*>(The_Arena()->alloc(n*sizeof(Real)));
+        m_overflow.push_back(p);
+    }
+
+    fab = FArrayBox(box, ncomp, p);
+}
+
+void
+HydroScratch::release (FArrayBox& fab)
+{
+    auto it = m_elixirs.find(&fab);
+    if (it != m_elixirs.end())
+    {
+        it->second.clear();
+        m_elixirs.erase(it);
+    }
+}
+
+void
+HydroScratch::reset ()
+{
+    m_elixirs.clear();
+
+    if (!m_overflow.empty())
+    {
+        const std::size_t need = m_need;
+        free_blocks();
+        m_size = need;
+        m_base = static_cast<Real*>(The_Arena()->alloc(m_size*sizeof(Real)));
+    }
+
+    m_top  = 0;
+    m_need = 0;
+}
+
+void
+HydroScratch::free_blocks ()
+{
+    for (Real* p : m_overflow)
+        The_Arena()->free(p);
+    m_overflow.clear();
+
+    if (m_base)
+        The_Arena()->free(m_base);
+    m_base = nullptr;
+    m_size = 0;
+    m_top  = 0;
+    m_need = 0;
+}
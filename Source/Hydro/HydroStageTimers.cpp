@@ -0,0 +1,133 @@
+#include <HydroStageTimers.H>
+
+#include <AMReX_Print.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+bool HydroStageTimers::s_on = false;
+
+namespace {
+    // One 64-byte line per thread so the threads do not share them
+    struct alignas(64) StageSeconds
+    {
+        double s[HydroStageTimers::NumStages] = {};
+    };
+
+    long cells_advanced = 0;
+
+    Vector<StageSeconds>& seconds_pool ()
+    {
+#ifdef _OPENMP
+        static Vector<StageSeconds> pool(omp_get_max_threads());
+#else
+        static Vector<StageSeconds> pool(1);
+#endif
+        return pool;
+    }
+
+    int nthreads ()
+    {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+}
+
+const char*
+HydroStageTimers::name (int stage)
+{
+    static const char* names[NumStages] = {"ctoprim", "flatten", "trace", "trans",
+                                           "riemann", "consup", "update", "fortran_hydro"};
+    return names[stage];
+}
+
+void
+HydroStageTimers::enable (bool on)
+{
+    s_on = on;
+    seconds_pool();
+}
+
+void
+HydroStageTimers::reset ()
+{
+    for (StageSeconds& t : seconds_pool())
+        t = StageSeconds();
+    cells_advanced = 0;
+}
+
+void
+HydroStageTimers::add_cells (long ncells)
+{
+    cells_advanced += ncells;
+}
+
+void
+HydroStageTimers::charge (int stage, double seconds)
+{
+#ifdef _OPENMP
+    if (omp_in_parallel())
+    {
+        seconds_pool()[omp_get_thread_num()].s[stage] += seconds;
+        return;
+    }
+#endif
+    seconds_pool()[0].s[stage] += seconds * nthreads();
+}
+
+void
+HydroStageTimers::totals (Vector<Real>& seconds, long& ncells)
+{
+    seconds.assign(NumStages, 0.0);
+    for (const StageSeconds& t : seconds_pool())
+        for (int n = 0; n < NumStages; ++n)
+            seconds[n] += t.s[n];
+
+    ParallelDescriptor::ReduceRealSum(seconds.dataPtr(), NumStages);
+    ncells = cells_advanced;
+}
+
+void
+HydroStageTimers::print ()
+{
+    Vector<Real> seconds;
+    long ncells;
+    totals(seconds, ncells);
+
+    amrex::Print() << "Hydro stage timers (core-seconds, ns per cell update) over "
+                   << ncells << " cell updates:\n";
+    for (int n = 0; n < NumStages; ++n)
+    {
+        if (seconds[n] == 0.0) continue;
+        amrex::Print() << "  " << name(n) << "  " << seconds[n] << "  "
+                       << (ncells > 0 ? 1.e9 * seconds[n] / ncells : 0.0) << '\n';
+    }
+}
+
+void
+HydroStageTimer::mark (int stage)
+{
+    if (!HydroStageTimers::on()) return;
+
+    const double now = ParallelDescriptor::second();
+    if (m_stage >= 0)
+        HydroStageTimers::charge(m_stage, now - m_start);
+    m_stage = stage;
+    m_start = now;
+}
+
+void
+HydroStageTimer::stop ()
+{
+    if (m_stage < 0) return;
+
+    HydroStageTimers::charge(m_stage, ParallelDescriptor::second() - m_start);
+    m_stage = -1;
+}
@@ -1,5 +1,8 @@
 #include "Nyx.H"
 #include "Nyx_F.H"
+#include "HydroScratch.H"
+#include "BoundaryFluxes.H"
+#include "AtomicRatesCache.H"
 
 #define BL_ARR4_TO_FORTRAN_3D(a) a.p,&((a).begin.x),amrex::GpuArray<int,3>{(a).end.x-1,(a).end.y-1,(a).end.z-1}.data()
 #define BL_ARR4_TO_FORTRAN(a) (a).p, AMREX_ARLIM(&((a).begin.x)), (a).end.x-1,(a).end.y-1,(a).end.z-1
@@ -28,15 +31,13 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
   long int old_store_steps=old_max_sundials_steps;
   long int new_store_steps=new_max_sundials_steps;
   
-  FArrayBox hydro_source;
-  FArrayBox ext_src_old;
 #ifdef HEATCOOL
 #ifndef FORCING
     {
       const Real z = 1.0/a - 1.0;
-      fort_interp_to_this_z(&z);
+      AtomicRatesCache::interp_to_z(z);
       const Real z_2 = 1.0/a_2 - 1.0;
-      fort_interp_to_this_z(&z_2);
+      AtomicRatesCache::interp_to_z(z_2);
     }
 #endif
 
@@ -58,7 +59,6 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
     int print_fortran_warnings_tmp=print_fortran_warnings;
     int do_grav_tmp=do_grav;
 
-    FArrayBox sum_state, divu_cc_small;
     BL_PROFILE_VAR_STOP(update_sources);
   BL_PROFILE("Nyx::construct_ctu_hydro_source()");
 
@@ -69,14 +69,19 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
   
   const Real strt_time = ParallelDescriptor::second();
 
+  // The fused driver integrates the grown tiles first, so it needs the
+  // ghost cells up front
+  hydro_fill_finish(Sborder, D_border);
+
   // this constructs the hydrodynamic source (essentially the flux
   // divergence) using the CTU framework for unsplit hydrodynamics
 
   if (verbose && ParallelDescriptor::IOProcessor())
     std::cout << "... Entering construct_ctu_hydro_source" << std::endl << std::endl;
 
-  // Compute_hydro_sources style
-  MultiFab fluxes[BL_SPACEDIM];
+  // Compute_hydro_sources style, but only the faces the flux registers read
+  // are kept
+  BoundaryFluxes fluxes;
   const int finest_level = parent->finestLevel();
 
   //
@@ -87,12 +92,6 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
 
   if(finest_level!=0)
     {
-      for (int j = 0; j < BL_SPACEDIM; j++)
-        {
-          fluxes[j].define(getEdgeBoxArray(j), dmap, NUM_STATE, 0);
-          fluxes[j].setVal(0.0);
-        }
-
     if (do_reflux)
     {
       if (level < finest_level)
@@ -105,6 +104,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
        if (level > 0) {
          current = &get_flux_reg(level);
        }
+       if (add_to_flux_register)
+         fluxes.define(grids, dmap, NUM_STATE, current != 0,
+                       fine ? &parent->boxArray(level+1) : nullptr,
+                       fine ? parent->refRatio(level) : IntVect::TheUnitVector());
     }
 
     }
@@ -139,6 +142,11 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
 
   MultiFab& S_new = get_new_data(State_Type);
   MultiFab& D_new = get_new_data(DiagEOS_Type);
+#ifdef HEATCOOL
+  // Fetched outside the OpenMP region since it may allocate
+  MultiFab& hc_cost = get_heat_cool_cost();
+  MultiFab& hc_lazy = get_heat_cool_lazy_state();
+#endif
 
   Real mass_lost = 0.;
   Real xmom_lost = 0.;
@@ -151,6 +159,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
   /*
   amrex::Print()<<"construct_hydro after multifabs, before fabarrays"<<std::endl;
   amrex::Arena::PrintUsage();*/
+  if (riemann_batched)
+      riemann_rows_init();
+
   BL_PROFILE_VAR("Nyx::advance_hydro_ca_umdrv()", CA_UMDRV);
 
 #ifdef _OPENMP
@@ -160,10 +171,14 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
   {
 
     // Declare local storage now. This should be done outside the MFIter loop,
-    // and then we will resize the Fabs in each MFIter loop iteration. Then,
-    // we apply an Elixir to ensure that their memory is saved until it is no
-    // longer needed (only relevant for the asynchronous case, usually on GPUs).
+    // and then each MFIter loop iteration points the Fabs into this thread's
+    // scratch arena, which is reset at the start of the next tile (on GPUs the
+    // arena resizes the Fabs and holds an Elixir until released).
 
+    HydroScratch& scratch = HydroScratch::get();
+
+    FArrayBox hydro_source, ext_src_old;
+    FArrayBox sum_state, divu_cc_small;
     FArrayBox q, qaux, src_q;
     FArrayBox flatn;
     FArrayBox dq;
@@ -258,11 +273,13 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
 
         const auto state4 = Sborder.array(mfi);
         const auto diag_eos4 = D_border.array(mfi);
-        integrate_state_vec_mfin(state4,diag_eos4,tbx,a,half_dt,old_store_steps,old_max_sundials_steps);
+        integrate_state_vec_mfin(state4,diag_eos4,tbx,a,half_dt,old_store_steps,old_max_sundials_steps,hc_cost.array(mfi),hc_lazy.array(mfi));
         //not sure if this is necessary for anything except timers
         amrex::Gpu::streamSynchronize();
       }
 #endif
+      scratch.reset();
+
       // the valid region box
       const Box& bx = mfi.tilebox();
 
@@ -273,19 +290,76 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
 
       const Box& qbx = amrex::grow(bx,NUM_GROW);
 
-      q.resize(qbx, QVAR);
-      Elixir elix_q = q.elixir();
+      scratch.alloc(q, qbx, QVAR);
 
-      qaux.resize(qbx, 1);
-      Elixir elix_qaux = qaux.elixir();
+      scratch.alloc(qaux, qbx, 1);
 
-      src_q.resize(qbx, NQSRC);
-      Elixir elix_src_q = src_q.elixir();
+      scratch.alloc(src_q, qbx, NQSRC);
 
       const auto fab_q = q.array();
       const auto fab_qaux = qaux.array();
       const auto fab_src_q = src_q.array();
 
+        scratch.alloc(ext_src_old, qbx,NUM_STATE);
+        const auto fab_sources_for_hydro = ext_src_old.array();
+
+        const int numcomp = NUM_STATE;
+        AMREX_HOST_DEVICE_FOR_4D(qbx,numcomp, i,j,k,n,
+        {
+          fab_sources_for_hydro(i,j,k,n)=0.0;
+        });
+
+      scratch.alloc(flatn, obx, 1);
+      Array4<Real> fab_flatn = flatn.array();
+      Array4<Real> flatn_arr = flatn.array();
+
+      const Box& xbx = amrex::surroundingNodes(bx, 0);
+      const Box& gxbx = amrex::grow(xbx, 1);
+      const Box& ybx = amrex::surroundingNodes(bx, 1);
+      const Box& gybx = amrex::grow(ybx, 1);
+      const Box& zbx = amrex::surroundingNodes(bx, 2);
+      const Box& gzbx = amrex::grow(zbx, 1);
+
+      scratch.alloc(shk, obx, 1);
+
+      scratch.alloc(qxm, obx, QVAR);
+
+      scratch.alloc(qxp, obx, QVAR);
+
+      scratch.alloc(qym, obx, QVAR);
+
+      scratch.alloc(qyp, obx, QVAR);
+
+      scratch.alloc(qzm, obx, QVAR);
+
+      scratch.alloc(qzp, obx, QVAR);
+
+    const auto fab_shk = shk.array();
+    const auto fab_qxm = qxm.array();
+    const auto fab_qxp = qxp.array();
+    const auto fab_qym = qym.array();
+    const auto fab_qyp = qyp.array();
+    const auto fab_qzm = qzm.array();
+    const auto fab_qzp = qzp.array();
+
+    scratch.alloc(dq, obx, QVAR);
+    const auto fab_dq = dq.array();
+
+      scratch.alloc(div, obx, 1);
+    const auto fab_div = div.array();
+
+      if (hydro_slab_planes > 0)
+      {
+        // cons -> prim through divu, fused over slabs of hydro_slab_planes planes
+        ctu_slab_states(bx, hydro_slab_planes,
+                        Sborder[mfi], grav_vector[mfi], ext_src_old,
+                        q, qaux, src_q, flatn, shk, dq,
+                        qxm, qxp, qym, qyp, qzm, qzp, div,
+                        dx.data(), dt, a_old, a_new, domain_lo, domain_hi);
+      }
+      else
+      {
+
         //      const Box& qbx = mfi.tilebox();
 
         // Convert the conservative state to the primitive variable state.
@@ -301,10 +375,6 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                    BL_ARR4_TO_FORTRAN_3D(fab_qaux));
         });
 
-        ext_src_old.resize(qbx,NUM_STATE);
-        Elixir elix_ext_src_old = ext_src_old.elixir();
-        const auto fab_sources_for_hydro = ext_src_old.array();
-
         // Convert the source terms expressed as sources to the conserved state to those
         // expressed as sources for the primitive state.
         q.prefetchToDevice();
@@ -313,12 +383,6 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
         ext_src_old.prefetchToDevice();
         src_q.prefetchToDevice();
 
-        const int numcomp = NUM_STATE;
-        AMREX_HOST_DEVICE_FOR_4D(qbx,numcomp, i,j,k,n,
-        {
-          fab_sources_for_hydro(i,j,k,n)=0.0;
-        });
-                                   
         AMREX_LAUNCH_DEVICE_LAMBDA(qbx, tqbx,
         {
         ca_srctoprim(AMREX_INT_ANYD(tqbx.loVect()), AMREX_INT_ANYD(tqbx.hiVect()),
@@ -331,20 +395,13 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
         });
 
 
-        if(finest_level!=0)
-          GpuArray<Array4<Real>, AMREX_SPACEDIM> fab_fluxes{AMREX_D_DECL(fluxes[0].array(mfi),
-                                                                   fluxes[1].array(mfi), fluxes[2].array(mfi))};
       
       //      q.resize(obx, 1);
       //      Elixir elix_q = q.elixir();
       
-      flatn.resize(obx, 1);
-      Elixir elix_flatn = flatn.elixir();
-      Array4<Real> fab_flatn = flatn.array();
       // compute the flattening coefficient
       // compute the flattening coefficient
 
-      Array4<Real> flatn_arr = flatn.array();
       ////      amrex::Print()<<"created array"<<std::endl;
       int pres_comp = QPRES;
 
@@ -371,45 +428,6 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
         AMREX_PARALLEL_FOR_3D(obx, i, j, k, { flatn_arr(i,j,k) = 1.0; });
       }
 
-      const Box& xbx = amrex::surroundingNodes(bx, 0);
-      const Box& gxbx = amrex::grow(xbx, 1);
-      const Box& ybx = amrex::surroundingNodes(bx, 1);
-      const Box& gybx = amrex::grow(ybx, 1);
-      const Box& zbx = amrex::surroundingNodes(bx, 2);
-      const Box& gzbx = amrex::grow(zbx, 1);
-
-      shk.resize(obx, 1);
-      Elixir elix_shk = shk.elixir();
-
-      qxm.resize(obx, QVAR);
-      Elixir elix_qxm = qxm.elixir();
-
-      qxp.resize(obx, QVAR);
-      Elixir elix_qxp = qxp.elixir();
-
-      qym.resize(obx, QVAR);
-      Elixir elix_qym = qym.elixir();
-
-      qyp.resize(obx, QVAR);
-      Elixir elix_qyp = qyp.elixir();
-
-      qzm.resize(obx, QVAR);
-      Elixir elix_qzm = qzm.elixir();
-
-      qzp.resize(obx, QVAR);
-      Elixir elix_qzp = qzp.elixir();
-
-    const auto fab_shk = shk.array();
-    const auto fab_qxm = qxm.array();
-    const auto fab_qxp = qxp.array();
-    const auto fab_qym = qym.array();
-    const auto fab_qyp = qyp.array();
-    const auto fab_qzm = qzm.array();
-    const auto fab_qzp = qzp.array();
-
-    dq.resize(obx, QVAR);
-    Elixir elix_dq = dq.elixir();
-    const auto fab_dq = dq.array();
 
       //      amrex::Print()<<"flatn"<<std::endl;
       
@@ -480,7 +498,6 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       });
 
 
-      elix_flatn.clear();
       //      amrex::Print()<<"1"<<std::endl;
       //////      amrex::Gpu::Device::synchronize();
       
@@ -489,29 +506,21 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
 
         amrex::Abort("Entered ppm_type=1 loop in hydro_convert which is not well tested");
         /*
-        Ip.resize(obx, 3*QVAR);
-        Elixir elix_Ip = Ip.elixir();
+        scratch.alloc(Ip, obx, 3*QVAR);
 
-        Im.resize(obx, 3*QVAR);
-        Elixir elix_Im = Im.elixir();
+        scratch.alloc(Im, obx, 3*QVAR);
 
-        Ip_src.resize(obx, 3*NQSRC);
-        Elixir elix_Ip_src = Ip_src.elixir();
+        scratch.alloc(Ip_src, obx, 3*NQSRC);
 
-        Im_src.resize(obx, 3*NQSRC);
-        Elixir elix_Im_src = Im_src.elixir();
+        scratch.alloc(Im_src, obx, 3*NQSRC);
 
-        Ip_gc.resize(obx, 3);
-        Elixir elix_Ip_gc = Ip_gc.elixir();
+        scratch.alloc(Ip_gc, obx, 3);
 
-        Im_gc.resize(obx, 3);
-        Elixir elix_Im_gc = Im_gc.elixir();
+        scratch.alloc(Im_gc, obx, 3);
 
-        sm.resize(obx, AMREX_SPACEDIM);
-        Elixir elix_sm = sm.elixir();
+        scratch.alloc(sm, obx, AMREX_SPACEDIM);
 
-        sp.resize(obx, AMREX_SPACEDIM);
-        Elixir elix_sp = sp.elixir();
+        scratch.alloc(sp, obx, AMREX_SPACEDIM);
     const auto fab_Ip = Ip.array();
     const auto fab_Im = Im.array();
     const auto fab_Ip_src = Ip_src.array();
@@ -547,9 +556,6 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
         */
       }
 
-      div.resize(obx, 1);
-      Elixir elix_div = div.elixir();
-    const auto fab_div = div.array();
       // compute divu -- we'll use this later when doing the artifical viscosity
 
     q.prefetchToDevice();
@@ -564,49 +570,39 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
            BL_ARR4_TO_FORTRAN_3D(fab_div));
       });
 
-      elix_q.clear();
+      }
+
+      scratch.release(flatn);
+      scratch.release(q);
       ///      amrex::Print()<<"1"<<std::endl;
       //amrex::Gpu::Device::streamSynchronize();
       
 
-      q_int.resize(obx, QVAR);
-      Elixir elix_q_int = q_int.elixir();
+      scratch.alloc(q_int, obx, QVAR);
 
-      flux[0].resize(gxbx, NUM_STATE);
-      Elixir elix_flux_x = flux[0].elixir();
+      scratch.alloc(flux[0], gxbx, NUM_STATE);
 
-      qe[0].resize(gxbx, NGDNV);
-      Elixir elix_qe_x = qe[0].elixir();
+      scratch.alloc(qe[0], gxbx, NGDNV);
 
-      flux[1].resize(gybx, NUM_STATE);
-      Elixir elix_flux_y = flux[1].elixir();
+      scratch.alloc(flux[1], gybx, NUM_STATE);
 
-      qe[1].resize(gybx, NGDNV);
-      Elixir elix_qe_y = qe[1].elixir();
+      scratch.alloc(qe[1], gybx, NGDNV);
 
-      flux[2].resize(gzbx, NUM_STATE);
-      Elixir elix_flux_z = flux[2].elixir();
+      scratch.alloc(flux[2], gzbx, NUM_STATE);
 
-      qe[2].resize(gzbx, NGDNV);
-      Elixir elix_qe_z = qe[2].elixir();
+      scratch.alloc(qe[2], gzbx, NGDNV);
 
-      ftmp1.resize(obx, NUM_STATE);
-      Elixir elix_ftmp1 = ftmp1.elixir();
+      scratch.alloc(ftmp1, obx, NUM_STATE);
 
-      ftmp2.resize(obx, NUM_STATE);
-      Elixir elix_ftmp2 = ftmp2.elixir();
+      scratch.alloc(ftmp2, obx, NUM_STATE);
 
-      qgdnvtmp1.resize(obx, NGDNV);
-      Elixir elix_qgdnvtmp1 = qgdnvtmp1.elixir();
+      scratch.alloc(qgdnvtmp1, obx, NGDNV);
 
-      qgdnvtmp2.resize(obx, NGDNV);
-      Elixir elix_qgdnvtmp2 = qgdnvtmp2.elixir();
+      scratch.alloc(qgdnvtmp2, obx, NGDNV);
 
-      ql.resize(obx, QVAR);
-      Elixir elix_ql = ql.elixir();
+      scratch.alloc(ql, obx, QVAR);
 
-      qr.resize(obx, QVAR);
-      Elixir elix_qr = qr.elixir();
+      scratch.alloc(qr, obx, QVAR);
 
     const auto fab_q_int = q_int.array();
     const auto fab_ftmp1 = ftmp1.array();
@@ -657,6 +653,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(cxbx, 1, fab_qxm, fab_qxp, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cxbx, tcxbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcxbx.loVect()), AMREX_INT_ANYD(tcxbx.hiVect()),
@@ -669,6 +668,7 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           1, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
       ///      amrex::Print()<<"1"<<std::endl;
       //amrex::Gpu::Device::streamSynchronize();
       
@@ -676,11 +676,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       // [lo(1), lo(2), lo(3)-1], [hi(1), hi(2)+1, hi(3)+1]
       const Box& tyxbx = amrex::grow(ybx, IntVect(AMREX_D_DECL(0,0,1)));
 
-      qyx.resize(tyxbx, QVAR);
-      Elixir elix_qyx = qyx.elixir();
+      scratch.alloc(qyx, tyxbx, QVAR);
 
-      qpyx.resize(tyxbx, QVAR);
-      Elixir elix_qpyx = qpyx.elixir();
+      scratch.alloc(qpyx, tyxbx, QVAR);
 
     const auto fab_qyx = qyx.array();
     const auto fab_qpyx = qpyx.array();
@@ -708,11 +706,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       // [lo(1), lo(2)-1, lo(3)], [hi(1), hi(2)+1, hi(3)+1]
       const Box& tzxbx = amrex::grow(zbx, IntVect(AMREX_D_DECL(0,1,0)));
 
-      qzx.resize(tzxbx, QVAR);
-      Elixir elix_qzx = qzx.elixir();
+      scratch.alloc(qzx, tzxbx, QVAR);
 
-      qpzx.resize(tzxbx, QVAR);
-      Elixir elix_qpzx = qpzx.elixir();
+      scratch.alloc(qpzx, tzxbx, QVAR);
 
       const auto fab_qzx = qzx.array();
       const auto fab_qpzx = qpzx.array();
@@ -755,6 +751,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(cybx, 2, fab_qym, fab_qyp, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cybx, tcybx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcybx.loVect()), AMREX_INT_ANYD(tcybx.hiVect()),
@@ -767,16 +766,15 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           2, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
       //amrex::Gpu::Device::streamSynchronize();
       
       // [lo(1), lo(2), lo(3)-1], [hi(1)+1, hi(2), lo(3)+1]
       const Box& txybx = amrex::grow(xbx, IntVect(AMREX_D_DECL(0,0,1)));
 
-      qxy.resize(txybx, QVAR);
-      Elixir elix_qxy = qxy.elixir();
+      scratch.alloc(qxy, txybx, QVAR);
 
-      qpxy.resize(txybx, QVAR);
-      Elixir elix_qpxy = qpxy.elixir();
+      scratch.alloc(qpxy, txybx, QVAR);
     const auto fab_qxy = qxy.array();
     const auto fab_qpxy = qpxy.array();
 
@@ -808,11 +806,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       // [lo(1)-1, lo(2), lo(3)], [hi(1)+1, hi(2), lo(3)+1]
       const Box& tzybx = amrex::grow(zbx, IntVect(AMREX_D_DECL(1,0,0)));
 
-      qzy.resize(tzybx, QVAR);
-      Elixir elix_qzy = qzy.elixir();
+      scratch.alloc(qzy, tzybx, QVAR);
 
-      qpzy.resize(tzybx, QVAR);
-      Elixir elix_qpzy = qpzy.elixir();
+      scratch.alloc(qpzy, tzybx, QVAR);
 
     const auto fab_qzy = qzy.array();
     const auto fab_qpzy = qpzy.array();
@@ -855,6 +851,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(czbx, 3, fab_qzm, fab_qzp, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(czbx, tczbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tczbx.loVect()), AMREX_INT_ANYD(tczbx.hiVect()),
@@ -867,16 +866,15 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           3, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
       //amrex::Gpu::Device::streamSynchronize();
       
       // [lo(1)-1, lo(2)-1, lo(3)], [hi(1)+1, hi(2)+1, lo(3)]
       const Box& txzbx = amrex::grow(xbx, IntVect(AMREX_D_DECL(0,1,0)));
 
-      qxz.resize(txzbx, QVAR);
-      Elixir elix_qxz = qxz.elixir();
+      scratch.alloc(qxz, txzbx, QVAR);
 
-      qpxz.resize(txzbx, QVAR);
-      Elixir elix_qpxz = qpxz.elixir();
+      scratch.alloc(qpxz, txzbx, QVAR);
 
     const auto fab_qxz = qxz.array();
     const auto fab_qpxz = qpxz.array();
@@ -908,11 +906,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       // [lo(1)-1, lo(2), lo(3)], [hi(1)+1, hi(2)+1, lo(3)]
       const Box& tyzbx = amrex::grow(ybx, IntVect(AMREX_D_DECL(1,0,0)));
 
-      qyz.resize(tyzbx, QVAR);
-      Elixir elix_qyz = qyz.elixir();
+      scratch.alloc(qyz, tyzbx, QVAR);
 
-      qpyz.resize(tyzbx, QVAR);
-      Elixir elix_qpyz = qpyz.elixir();
+      scratch.alloc(qpyz, tyzbx, QVAR);
 
       const auto fab_qyz = qyz.array();
       const auto fab_qpyz = qpyz.array();
@@ -961,6 +957,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(cyzbx, 2, fab_qyz, fab_qpyz, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cyzbx, tcyzbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcyzbx.loVect()), AMREX_INT_ANYD(tcyzbx.hiVect()),
@@ -973,9 +972,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           2, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qyz.clear();
-      elix_qpyz.clear();
+      scratch.release(qyz);
+      scratch.release(qpyz);
 
       // compute F^{z|y}
       // [lo(1)-1, lo(2), lo(3)], [hi(1)+1, hi(2), hi(3)+1]
@@ -993,6 +993,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(czybx, 3, fab_qzy, fab_qpzy, fab_qaux, fab_ftmp2, fab_qgdnvtmp2);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(czybx, tczybx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tczybx.loVect()), AMREX_INT_ANYD(tczybx.hiVect()),
@@ -1005,9 +1008,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           3, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qzy.clear();
-      elix_qpzy.clear();
+      scratch.release(qzy);
+      scratch.release(qpzy);
 
       qxm.prefetchToDevice();
       qxp.prefetchToDevice();
@@ -1038,8 +1042,8 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
               hdt, hdtdy, hdtdz, a_old, a_new);
       });
 
-      elix_qxm.clear();
-      elix_qxp.clear();
+      scratch.release(qxm);
+      scratch.release(qxp);
 
       ql.prefetchToDevice();
       qr.prefetchToDevice();
@@ -1049,6 +1053,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(xbx, 1, fab_ql, fab_qr, fab_qaux, fab_flux[0], fab_qe[0]);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(xbx, txbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(txbx.loVect()), AMREX_INT_ANYD(txbx.hiVect()),
@@ -1061,6 +1068,7 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           1, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
       //
       // Use qy?, q?zx, q?xz to compute final y-flux
@@ -1073,6 +1081,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       // ftmp1 = fzx
       // rftmp1 = rfzx
       // qgdnvtmp1 = qgdnvzx
+      if (riemann_batched) {
+        cmpflx_rows(czxbx, 3, fab_qzx, fab_qpzx, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(czxbx, tczxbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tczxbx.loVect()), AMREX_INT_ANYD(tczxbx.hiVect()),
@@ -1085,9 +1096,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           3, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qzx.clear();
-      elix_qpzx.clear();
+      scratch.release(qzx);
+      scratch.release(qpzx);
       
       // compute F^{x|z}
       // [lo(1), lo(2)-1, lo(3)], [hi(1)+1, hi(2)+1, hi(3)]
@@ -1105,6 +1117,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(cxzbx, 1, fab_qxz, fab_qpxz, fab_qaux, fab_ftmp2, fab_qgdnvtmp2);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cxzbx, tcxzbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcxzbx.loVect()), AMREX_INT_ANYD(tcxzbx.hiVect()),
@@ -1117,9 +1132,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           1, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qxz.clear();
-      elix_qpxz.clear();
+      scratch.release(qxz);
+      scratch.release(qpxz);
 
       qym.prefetchToDevice();
       qyp.prefetchToDevice();
@@ -1150,8 +1166,8 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
               hdt, hdtdx, hdtdz, a_old, a_new);
       });
 
-      elix_qym.clear();
-      elix_qyp.clear();
+      scratch.release(qym);
+      scratch.release(qyp);
 
       // Compute the final F^y
       ql.prefetchToDevice();
@@ -1162,6 +1178,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(ybx, 2, fab_ql, fab_qr, fab_qaux, fab_flux[1], fab_qe[1]);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(ybx, tybx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tybx.loVect()), AMREX_INT_ANYD(tybx.hiVect()),
@@ -1174,6 +1193,7 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           2, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
       //
       // Use qz?, q?xy, q?yx to compute final z-flux
@@ -1186,6 +1206,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       // ftmp1 = fxy
       // rftmp1 = rfxy
       // qgdnvtmp1 = qgdnvxy
+      if (riemann_batched) {
+        cmpflx_rows(cxybx, 1, fab_qxy, fab_qpxy, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cxybx, tcxybx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcxybx.loVect()), AMREX_INT_ANYD(tcxybx.hiVect()),
@@ -1198,9 +1221,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           1, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qxy.clear();
-      elix_qpxy.clear();
+      scratch.release(qxy);
+      scratch.release(qpxy);
       
       // compute F^{y|x}
       // [lo(1), lo(2), lo(3)-1], [hi(1), hi(2)+dg(2), hi(3)+1]
@@ -1218,6 +1242,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(cyxbx, 2, fab_qyx, fab_qpyx, fab_qaux, fab_ftmp2, fab_qgdnvtmp2);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cyxbx, tcyxbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcyxbx.loVect()), AMREX_INT_ANYD(tcyxbx.hiVect()),
@@ -1230,9 +1257,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           2, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qyx.clear();
-      elix_qpyx.clear();
+      scratch.release(qyx);
+      scratch.release(qpyx);
       
       qzm.prefetchToDevice();
       qzp.prefetchToDevice();
@@ -1263,13 +1291,13 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
               hdt, hdtdx, hdtdy, a_old, a_new);
       });
 
-      elix_src_q.clear();
-      elix_qzm.clear();
-      elix_qzp.clear();
-      elix_ftmp1.clear();
-      elix_ftmp2.clear();
-      elix_qgdnvtmp1.clear();
-      elix_qgdnvtmp2.clear();
+      scratch.release(src_q);
+      scratch.release(qzm);
+      scratch.release(qzp);
+      scratch.release(ftmp1);
+      scratch.release(ftmp2);
+      scratch.release(qgdnvtmp1);
+      scratch.release(qgdnvtmp2);
         
       // compute the final z fluxes F^z
 
@@ -1281,6 +1309,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      if (riemann_batched) {
+        cmpflx_rows(zbx, 3, fab_ql, fab_qr, fab_qaux, fab_flux[2], fab_qe[2]);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(zbx, tzbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tzbx.loVect()), AMREX_INT_ANYD(tzbx.hiVect()),
@@ -1294,12 +1325,13 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                           3, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
 
       });
+      }
 
-      elix_qaux.clear();
-      elix_q_int.clear();
-      elix_ql.clear();
-      elix_qr.clear();
-      elix_shk.clear();
+      scratch.release(qaux);
+      scratch.release(q_int);
+      scratch.release(ql);
+      scratch.release(qr);
+      scratch.release(shk);
 
       // clean the fluxes
       Sborder[mfi].prefetchToDevice();
@@ -1329,15 +1361,13 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
 
       }
 
-      elix_div.clear();
+      scratch.release(div);
 
 
-      pdivu.resize(bx, 1);
-      Elixir elix_pdivu = pdivu.elixir();
+      scratch.alloc(pdivu, bx, 1);
     const auto fab_pdivu = pdivu.array();
 
-    hydro_source.resize(bx,NUM_STATE);
-    Elixir elix_hydro_source = hydro_source.elixir();
+    scratch.alloc(hydro_source, bx,NUM_STATE);
       const auto fab_hydro_source = hydro_source.array();
 
       Sborder[mfi].prefetchToDevice();
@@ -1366,10 +1396,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                 dx.data(),dt,a_old,a_new);
             });
 
-      elix_qe_x.clear();
-      elix_qe_y.clear();
-      elix_qe_z.clear();
-      elix_pdivu.clear();
+      scratch.release(qe[0]);
+      scratch.release(qe[1]);
+      scratch.release(qe[2]);
+      scratch.release(pdivu);
 
       for (int idir = 0; idir < AMREX_SPACEDIM; ++idir) {
 
@@ -1395,22 +1425,14 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
 
       if(finest_level!=0)
         {
-        Array4<Real> const flux_fab = (flux[idir]).array();
-        Array4<Real> fluxes_fab = (fluxes[idir]).array(mfi);
-        const int numcomp = NUM_STATE;
-        fluxes[idir][mfi].prefetchToDevice();
         flux[idir].prefetchToDevice();
-
-            AMREX_HOST_DEVICE_FOR_4D(mfi.nodaltilebox(idir), numcomp, i, j, k, n,
-            {
-                fluxes_fab(i,j,k,n) += flux_fab(i,j,k,n);
-            });
+        fluxes.store(mfi, idir, flux[idir]);
         }
       } // idir loop
 
-      elix_flux_x.clear();
-      elix_flux_y.clear();
-      elix_flux_z.clear();
+      scratch.release(flux[0]);
+      scratch.release(flux[1]);
+      scratch.release(flux[2]);
 
       BL_PROFILE_VAR("Nyx::update_state_with_sources()",update_sources);
       const auto fab_S_new = S_new.array(mfi);
@@ -1420,12 +1442,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       const Box& bx = mfi.tilebox();
       const Box& obx = amrex::grow(bx, 1);
       */
-      sum_state.resize(obx, AMREX_SPACEDIM);
-      Elixir elix_s = sum_state.elixir();
+      scratch.alloc(sum_state, obx, AMREX_SPACEDIM);
       const auto fab_sum_state = sum_state.array();
 
-      divu_cc_small.resize(bx, 1);
-      Elixir elix_divu_cc_small = divu_cc_small.elixir();
+      scratch.alloc(divu_cc_small, bx, 1);
       const auto fab_divu_cc = divu_cc_small.array();
 
       Sborder[mfi].prefetchToDevice();
@@ -1460,10 +1480,10 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
                     &dt, &a_old, &a_new);
         });
 
-        elix_ext_src_old.clear();
-        elix_hydro_source.clear();
-        elix_s.clear();
-        elix_divu_cc_small.clear();
+        scratch.release(ext_src_old);
+        scratch.release(hydro_source);
+        scratch.release(sum_state);
+        scratch.release(divu_cc_small);
 
         //Unsure whether this stream synchronize is useful for anything other than profiling timers
         amrex::Gpu::streamSynchronize();
@@ -1507,7 +1527,7 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
 
         const auto state4 = S_new.array(mfi);
         const auto diag_eos4 = D_new.array(mfi);
-        integrate_state_vec_mfin(state4,diag_eos4,tbx,a_2,half_dt,new_store_steps,new_max_sundials_steps);
+        integrate_state_vec_mfin(state4,diag_eos4,tbx,a_2,half_dt,new_store_steps,new_max_sundials_steps,hc_cost.array(mfi),hc_lazy.array(mfi));
         //not sure if this is necessary for anything except timers
         amrex::Gpu::streamSynchronize();
       }
@@ -1516,6 +1536,9 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
       //amrex::Gpu::Device::synchronize();
     } // MFIter loop
 
+    // Views into the arena do not outlive the loop
+    scratch.reset();
+
 
   } // OMP loop
 
@@ -1545,18 +1568,8 @@ Nyx::ctu_hydro_fuse(amrex::Real time, amrex::Real dt, amrex::Real a_old, amrex::
   // These seem to check if the provided flux is a gpuptr, and use launches
     if (add_to_flux_register && finest_level!=0)
     {
-       if (do_reflux) {
-         if (current) {
-           for (int i = 0; i < BL_SPACEDIM ; i++) {
-             current->FineAdd(fluxes[i], i, 0, 0, NUM_STATE, 1);
-           }
-         }
-         if (fine) {
-           for (int i = 0; i < BL_SPACEDIM ; i++) {
-                 fine->CrseInit(fluxes[i],i,0,0,NUM_STATE,-1.,FluxRegister::ADD);
-           }
-         }
-       }
+       if (do_reflux)
+         fluxes.add_to_registers(current, fine);
     }
 
 }
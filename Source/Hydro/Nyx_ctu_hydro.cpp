@@ -1,5 +1,8 @@
 #include "Nyx.H"
 #include "Nyx_F.H"
+#include "HydroScratch.H"
+#include "HydroStageTimers.H"
+#include "BoundaryFluxes.H"
 
 #define BL_ARR4_TO_FORTRAN_3D(a) a.p,&((a).begin.x),amrex::GpuArray<int,3>{(a).end.x-1,(a).end.y-1,(a).end.z-1}.data()
 #define BL_ARR4_TO_FORTRAN(a) (a).p, AMREX_ARLIM(&((a).begin.x)), (a).end.x-1,(a).end.y-1,(a).end.z-1
@@ -31,8 +34,9 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
   if (verbose && ParallelDescriptor::IOProcessor())
     std::cout << "... Entering construct_ctu_hydro_source" << std::endl << std::endl;
 
-  // Compute_hydro_sources style
-  MultiFab fluxes[BL_SPACEDIM];
+  // Compute_hydro_sources style, but only the faces the flux registers read
+  // are kept
+  BoundaryFluxes fluxes;
   const int finest_level = parent->finestLevel();
 
   //
@@ -43,12 +47,6 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
 
   if(finest_level!=0)
     {
-      for (int j = 0; j < BL_SPACEDIM; j++)
-        {
-          fluxes[j].define(getEdgeBoxArray(j), dmap, NUM_STATE, 0);
-          fluxes[j].setVal(0.0);
-        }
-
     if (do_reflux)
     {
       if (level < finest_level)
@@ -61,6 +59,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
        if (level > 0) {
          current = &get_flux_reg(level);
        }
+       if (add_to_flux_register)
+         fluxes.define(grids, dmap, NUM_STATE, current != 0,
+                       fine ? &parent->boxArray(level+1) : nullptr,
+                       fine ? parent->refRatio(level) : IntVect::TheUnitVector());
     }
 
     }
@@ -103,21 +105,46 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
   Real xang_lost = 0.;
   Real yang_lost = 0.;
   Real zang_lost = 0.;
+  int ntiles_skipped = 0;
+  long ncells_overlapped = 0;
   /*
   amrex::Print()<<"construct_hydro after multifabs, before fabarrays"<<std::endl;
   amrex::Arena::PrintUsage();*/
+  if (riemann_batched)
+      riemann_rows_init();
+  if (hydro_specialize)
+      hydro_kernels_init();
+
+  // Quiescent tiles (nyx.hydro_skip_tol)
+  iMultiFab skip_mask;
+  if (hydro_skip_tol > 0)
+      hydro_quiescent_mask(Sborder, skip_mask, &fluxes);
+
   BL_PROFILE_VAR("Nyx::advance_hydro_ca_umdrv()", CA_UMDRV);
 
+  // If the ghost-cell exchange is still in flight (nyx.hydro_overlap_fill),
+  // the cells of each tile that only read valid cells go first and the strips
+  // around them wait for it
+  const int npasses = hydro_fill_pending ? 2 : 1;
+
+  for (int pass = 0; pass < npasses; ++pass) {
+
+  if (pass == 1)
+      hydro_fill_finish(Sborder, D_border);
+
 #ifdef _OPENMP
 #pragma omp parallel reduction(+:mass_lost,xmom_lost,ymom_lost,zmom_lost) \
-                     reduction(+:eden_lost,xang_lost,yang_lost,zang_lost)
+                     reduction(+:eden_lost,xang_lost,yang_lost,zang_lost) \
+                     reduction(+:ntiles_skipped,ncells_overlapped)
 #endif
   {
 
     // Declare local storage now. This should be done outside the MFIter loop,
-    // and then we will resize the Fabs in each MFIter loop iteration. Then,
-    // we apply an Elixir to ensure that their memory is saved until it is no
-    // longer needed (only relevant for the asynchronous case, usually on GPUs).
+    // and then each MFIter loop iteration points the Fabs into this thread's
+    // scratch arena, which is reset at the start of the next tile (on GPUs the
+    // arena resizes the Fabs and holds an Elixir until released).
+
+    HydroScratch& scratch = HydroScratch::get();
 
     FArrayBox q, qaux, src_q;
     FArrayBox flatn;
@@ -203,8 +230,25 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
     for (MFIter mfi(S_new, TilingIfNotGPU()); mfi.isValid(); ++mfi, Nyx::minimize_memory!=0 ? amrex::Gpu::synchronize() : amrex::Gpu::streamSynchronize() ) {
       //      for (MFIter mfi(S_new, hydro_tile_size); mfi.isValid(); ++mfi) {
 
-      // the valid region box
-      const Box& bx = mfi.tilebox();
+      // the valid region box, or the part of it done in this pass
+      for (const Box& bx : hydro_pass_boxes(mfi, npasses, pass)) {
+
+      if (npasses == 2 && pass == 0)
+          ncells_overlapped += bx.numPts();
+
+      scratch.reset();
+      HydroStageTimer stage_timer;
+
+      // Quiescent floor-density tiles (nyx.hydro_skip_tol) only get the
+      // fluxes of their mean face states
+      if (hydro_skip_tol > 0 && hydro_tile_skip(mfi, skip_mask))
+      {
+          stage_timer.mark(HydroStageTimers::Consup);
+          hydro_quiescent_source(bx, Sborder[mfi], hydro_source[mfi],
+                                 dx.data(), dt, a_old, a_new);
+          ++ntiles_skipped;
+          continue;
+      }
 
       const Box& obx = amrex::grow(bx, 1);
 
@@ -215,19 +259,70 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
 
       const Box& qbx = amrex::grow(bx,NUM_GROW);
 
-      q.resize(qbx, QVAR);
-      Elixir elix_q = q.elixir();
+      scratch.alloc(q, qbx, QVAR);
 
-      qaux.resize(qbx, 1);
-      Elixir elix_qaux = qaux.elixir();
+      scratch.alloc(qaux, qbx, 1);
 
-      src_q.resize(qbx, NQSRC);
-      Elixir elix_src_q = src_q.elixir();
+      scratch.alloc(src_q, qbx, NQSRC);
 
       const auto fab_q = q.array();
       const auto fab_qaux = qaux.array();
       const auto fab_src_q = src_q.array();
 
+      scratch.alloc(flatn, obx, 1);
+      Array4<Real> fab_flatn = flatn.array();
+      Array4<Real> flatn_arr = flatn.array();
+
+      const Box& xbx = amrex::surroundingNodes(bx, 0);
+      const Box& gxbx = amrex::grow(xbx, 1);
+      const Box& ybx = amrex::surroundingNodes(bx, 1);
+      const Box& gybx = amrex::grow(ybx, 1);
+      const Box& zbx = amrex::surroundingNodes(bx, 2);
+      const Box& gzbx = amrex::grow(zbx, 1);
+
+      scratch.alloc(shk, obx, 1);
+
+      scratch.alloc(qxm, obx, QVAR);
+
+      scratch.alloc(qxp, obx, QVAR);
+
+      scratch.alloc(qym, obx, QVAR);
+
+      scratch.alloc(qyp, obx, QVAR);
+
+      scratch.alloc(qzm, obx, QVAR);
+
+      scratch.alloc(qzp, obx, QVAR);
+
+    const auto fab_shk = shk.array();
+    const auto fab_qxm = qxm.array();
+    const auto fab_qxp = qxp.array();
+    const auto fab_qym = qym.array();
+    const auto fab_qyp = qyp.array();
+    const auto fab_qzm = qzm.array();
+    const auto fab_qzp = qzp.array();
+
+    scratch.alloc(dq, obx, QVAR);
+    const auto fab_dq = dq.array();
+
+      scratch.alloc(div, obx, 1);
+    const auto fab_div = div.array();
+
+      stage_timer.mark(HydroStageTimers::Ctoprim);
+
+      if (hydro_slab_planes > 0)
+      {
+        // cons -> prim through divu, fused over slabs of hydro_slab_planes planes
+        // (all charged to the ctoprim stage timer)
+        ctu_slab_states(bx, hydro_slab_planes,
+                        Sborder[mfi], grav_vector[mfi], ext_src_old[mfi],
+                        q, qaux, src_q, flatn, shk, dq,
+                        qxm, qxp, qym, qyp, qzm, qzp, div,
+                        dx.data(), dt, a_old, a_new, domain_lo, domain_hi);
+      }
+      else
+      {
+
         //      const Box& qbx = mfi.tilebox();
 
         // Convert the conservative state to the primitive variable state.
@@ -262,20 +357,13 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
         });
 
 
-        if(finest_level!=0)
-          GpuArray<Array4<Real>, AMREX_SPACEDIM> fab_fluxes{AMREX_D_DECL(fluxes[0].array(mfi),
-                                                                   fluxes[1].array(mfi), fluxes[2].array(mfi))};
       
       //      q.resize(obx, 1);
       //      Elixir elix_q = q.elixir();
       
-      flatn.resize(obx, 1);
-      Elixir elix_flatn = flatn.elixir();
-      Array4<Real> fab_flatn = flatn.array();
       // compute the flattening coefficient
       // compute the flattening coefficient
 
-      Array4<Real> flatn_arr = flatn.array();
       ////      amrex::Print()<<"created array"<<std::endl;
       int pres_comp = QPRES;
 
@@ -290,6 +378,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
           first=false;
           }*/
       
+      stage_timer.mark(HydroStageTimers::Flatten);
       if (use_flattening == 1) {
       AMREX_LAUNCH_DEVICE_LAMBDA(obx, tobx,
                 {
@@ -302,50 +391,25 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
         AMREX_PARALLEL_FOR_3D(obx, i, j, k, { flatn_arr(i,j,k) = 1.0; });
       }
 
-      const Box& xbx = amrex::surroundingNodes(bx, 0);
-      const Box& gxbx = amrex::grow(xbx, 1);
-      const Box& ybx = amrex::surroundingNodes(bx, 1);
-      const Box& gybx = amrex::grow(ybx, 1);
-      const Box& zbx = amrex::surroundingNodes(bx, 2);
-      const Box& gzbx = amrex::grow(zbx, 1);
-
-      shk.resize(obx, 1);
-      Elixir elix_shk = shk.elixir();
-
-      qxm.resize(obx, QVAR);
-      Elixir elix_qxm = qxm.elixir();
-
-      qxp.resize(obx, QVAR);
-      Elixir elix_qxp = qxp.elixir();
-
-      qym.resize(obx, QVAR);
-      Elixir elix_qym = qym.elixir();
 
-      qyp.resize(obx, QVAR);
-      Elixir elix_qyp = qyp.elixir();
+      //      amrex::Print()<<"flatn"<<std::endl;
+      
 
-      qzm.resize(obx, QVAR);
-      Elixir elix_qzm = qzm.elixir();
+      stage_timer.mark(HydroStageTimers::Trace);
 
-      qzp.resize(obx, QVAR);
-      Elixir elix_qzp = qzp.elixir();
+      if (ppm_type == 0 && hydro_specialize) {
 
-    const auto fab_shk = shk.array();
-    const auto fab_qxm = qxm.array();
-    const auto fab_qxp = qxp.array();
-    const auto fab_qym = qym.array();
-    const auto fab_qyp = qyp.array();
-    const auto fab_qzm = qzm.array();
-    const auto fab_qzp = qzp.array();
-
-    dq.resize(obx, QVAR);
-    Elixir elix_dq = dq.elixir();
-    const auto fab_dq = dq.array();
-
-      //      amrex::Print()<<"flatn"<<std::endl;
-      
+        for (int idir = 1; idir <= 3; ++idir)
+        {
+          FArrayBox& qm = (idir == 1) ? qxm : (idir == 2) ? qym : qzm;
+          FArrayBox& qp = (idir == 1) ? qxp : (idir == 2) ? qyp : qzp;
+          ctu_plm_states_spec(obx, bx, idir, q.const_array(), flatn.const_array(),
+                              qaux.const_array(), src_q.const_array(),
+                              fab_shk, fab_dq, qm.array(), qp.array(),
+                              dx.data(), dt, a_old);
+        }
 
-      if (ppm_type == 0) {
+      } else if (ppm_type == 0) {
 
         q.prefetchToDevice();
         qaux.prefetchToDevice();
@@ -411,7 +475,6 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       });
 
 
-      elix_flatn.clear();
       //      amrex::Print()<<"1"<<std::endl;
       //////      amrex::Gpu::Device::synchronize();
       
@@ -420,29 +483,21 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
 
         amrex::Abort("Entered ppm_type=1 loop in hydro_convert which is not well tested");
         /*
-        Ip.resize(obx, 3*QVAR);
-        Elixir elix_Ip = Ip.elixir();
+        scratch.alloc(Ip, obx, 3*QVAR);
 
-        Im.resize(obx, 3*QVAR);
-        Elixir elix_Im = Im.elixir();
+        scratch.alloc(Im, obx, 3*QVAR);
 
-        Ip_src.resize(obx, 3*NQSRC);
-        Elixir elix_Ip_src = Ip_src.elixir();
+        scratch.alloc(Ip_src, obx, 3*NQSRC);
 
-        Im_src.resize(obx, 3*NQSRC);
-        Elixir elix_Im_src = Im_src.elixir();
+        scratch.alloc(Im_src, obx, 3*NQSRC);
 
-        Ip_gc.resize(obx, 3);
-        Elixir elix_Ip_gc = Ip_gc.elixir();
+        scratch.alloc(Ip_gc, obx, 3);
 
-        Im_gc.resize(obx, 3);
-        Elixir elix_Im_gc = Im_gc.elixir();
+        scratch.alloc(Im_gc, obx, 3);
 
-        sm.resize(obx, AMREX_SPACEDIM);
-        Elixir elix_sm = sm.elixir();
+        scratch.alloc(sm, obx, AMREX_SPACEDIM);
 
-        sp.resize(obx, AMREX_SPACEDIM);
-        Elixir elix_sp = sp.elixir();
+        scratch.alloc(sp, obx, AMREX_SPACEDIM);
     const auto fab_Ip = Ip.array();
     const auto fab_Im = Im.array();
     const auto fab_Ip_src = Ip_src.array();
@@ -478,9 +533,8 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
         */
       }
 
-      div.resize(obx, 1);
-      Elixir elix_div = div.elixir();
-    const auto fab_div = div.array();
+      stage_timer.mark(HydroStageTimers::Consup);
+
       // compute divu -- we'll use this later when doing the artifical viscosity
 
     q.prefetchToDevice();
@@ -495,49 +549,39 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
            BL_ARR4_TO_FORTRAN_3D(fab_div));
       });
 
-      elix_q.clear();
+      }
+
+      scratch.release(flatn);
+      scratch.release(q);
       ///      amrex::Print()<<"1"<<std::endl;
       //amrex::Gpu::Device::streamSynchronize();
       
 
-      q_int.resize(obx, QVAR);
-      Elixir elix_q_int = q_int.elixir();
+      scratch.alloc(q_int, obx, QVAR);
 
-      flux[0].resize(gxbx, NUM_STATE);
-      Elixir elix_flux_x = flux[0].elixir();
+      scratch.alloc(flux[0], gxbx, NUM_STATE);
 
-      qe[0].resize(gxbx, NGDNV);
-      Elixir elix_qe_x = qe[0].elixir();
+      scratch.alloc(qe[0], gxbx, NGDNV);
 
-      flux[1].resize(gybx, NUM_STATE);
-      Elixir elix_flux_y = flux[1].elixir();
+      scratch.alloc(flux[1], gybx, NUM_STATE);
 
-      qe[1].resize(gybx, NGDNV);
-      Elixir elix_qe_y = qe[1].elixir();
+      scratch.alloc(qe[1], gybx, NGDNV);
 
-      flux[2].resize(gzbx, NUM_STATE);
-      Elixir elix_flux_z = flux[2].elixir();
+      scratch.alloc(flux[2], gzbx, NUM_STATE);
 
-      qe[2].resize(gzbx, NGDNV);
-      Elixir elix_qe_z = qe[2].elixir();
+      scratch.alloc(qe[2], gzbx, NGDNV);
 
-      ftmp1.resize(obx, NUM_STATE);
-      Elixir elix_ftmp1 = ftmp1.elixir();
+      scratch.alloc(ftmp1, obx, NUM_STATE);
 
-      ftmp2.resize(obx, NUM_STATE);
-      Elixir elix_ftmp2 = ftmp2.elixir();
+      scratch.alloc(ftmp2, obx, NUM_STATE);
 
-      qgdnvtmp1.resize(obx, NGDNV);
-      Elixir elix_qgdnvtmp1 = qgdnvtmp1.elixir();
+      scratch.alloc(qgdnvtmp1, obx, NGDNV);
 
-      qgdnvtmp2.resize(obx, NGDNV);
-      Elixir elix_qgdnvtmp2 = qgdnvtmp2.elixir();
+      scratch.alloc(qgdnvtmp2, obx, NGDNV);
 
-      ql.resize(obx, QVAR);
-      Elixir elix_ql = ql.elixir();
+      scratch.alloc(ql, obx, QVAR);
 
-      qr.resize(obx, QVAR);
-      Elixir elix_qr = qr.elixir();
+      scratch.alloc(qr, obx, QVAR);
 
     const auto fab_q_int = q_int.array();
     const auto fab_ftmp1 = ftmp1.array();
@@ -588,6 +632,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(cxbx, 1, fab_qxm, fab_qxp, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cxbx, tcxbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcxbx.loVect()), AMREX_INT_ANYD(tcxbx.hiVect()),
@@ -600,6 +648,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           1, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
       ///      amrex::Print()<<"1"<<std::endl;
       //amrex::Gpu::Device::streamSynchronize();
       
@@ -607,11 +656,9 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       // [lo(1), lo(2), lo(3)-1], [hi(1), hi(2)+1, hi(3)+1]
       const Box& tyxbx = amrex::grow(ybx, IntVect(AMREX_D_DECL(0,0,1)));
 
-      qyx.resize(tyxbx, QVAR);
-      Elixir elix_qyx = qyx.elixir();
+      scratch.alloc(qyx, tyxbx, QVAR);
 
-      qpyx.resize(tyxbx, QVAR);
-      Elixir elix_qpyx = qpyx.elixir();
+      scratch.alloc(qpyx, tyxbx, QVAR);
 
     const auto fab_qyx = qyx.array();
     const auto fab_qpyx = qpyx.array();
@@ -621,6 +668,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       // qgdnvtmp1 = qgdnvx
 #pragma gpu
       
+      stage_timer.mark(HydroStageTimers::Trans);
       AMREX_LAUNCH_DEVICE_LAMBDA(tyxbx, ttyxbx,
       {
       transx_on_ystates(AMREX_INT_ANYD(ttyxbx.loVect()), AMREX_INT_ANYD(ttyxbx.hiVect()),
@@ -639,11 +687,9 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       // [lo(1), lo(2)-1, lo(3)], [hi(1), hi(2)+1, hi(3)+1]
       const Box& tzxbx = amrex::grow(zbx, IntVect(AMREX_D_DECL(0,1,0)));
 
-      qzx.resize(tzxbx, QVAR);
-      Elixir elix_qzx = qzx.elixir();
+      scratch.alloc(qzx, tzxbx, QVAR);
 
-      qpzx.resize(tzxbx, QVAR);
-      Elixir elix_qpzx = qpzx.elixir();
+      scratch.alloc(qpzx, tzxbx, QVAR);
 
       const auto fab_qzx = qzx.array();
       const auto fab_qpzx = qpzx.array();
@@ -656,6 +702,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qgdnvtmp1.prefetchToDevice();
 
       
+      stage_timer.mark(HydroStageTimers::Trans);
       AMREX_LAUNCH_DEVICE_LAMBDA(tzxbx, ttzxbx,
       {
       transx_on_zstates(AMREX_INT_ANYD(ttzxbx.loVect()), AMREX_INT_ANYD(ttzxbx.hiVect()),
@@ -686,6 +733,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(cybx, 2, fab_qym, fab_qyp, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cybx, tcybx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcybx.loVect()), AMREX_INT_ANYD(tcybx.hiVect()),
@@ -698,16 +749,15 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           2, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
       //amrex::Gpu::Device::streamSynchronize();
       
       // [lo(1), lo(2), lo(3)-1], [hi(1)+1, hi(2), lo(3)+1]
       const Box& txybx = amrex::grow(xbx, IntVect(AMREX_D_DECL(0,0,1)));
 
-      qxy.resize(txybx, QVAR);
-      Elixir elix_qxy = qxy.elixir();
+      scratch.alloc(qxy, txybx, QVAR);
 
-      qpxy.resize(txybx, QVAR);
-      Elixir elix_qpxy = qpxy.elixir();
+      scratch.alloc(qpxy, txybx, QVAR);
     const auto fab_qxy = qxy.array();
     const auto fab_qpxy = qpxy.array();
 
@@ -722,6 +772,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       ftmp1.prefetchToDevice();
       qgdnvtmp1.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Trans);
       AMREX_LAUNCH_DEVICE_LAMBDA(txybx, ttxybx,
       {
       transy_on_xstates(AMREX_INT_ANYD(ttxybx.loVect()), AMREX_INT_ANYD(ttxybx.hiVect()),
@@ -739,11 +790,9 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       // [lo(1)-1, lo(2), lo(3)], [hi(1)+1, hi(2), lo(3)+1]
       const Box& tzybx = amrex::grow(zbx, IntVect(AMREX_D_DECL(1,0,0)));
 
-      qzy.resize(tzybx, QVAR);
-      Elixir elix_qzy = qzy.elixir();
+      scratch.alloc(qzy, tzybx, QVAR);
 
-      qpzy.resize(tzybx, QVAR);
-      Elixir elix_qpzy = qpzy.elixir();
+      scratch.alloc(qpzy, tzybx, QVAR);
 
     const auto fab_qzy = qzy.array();
     const auto fab_qpzy = qpzy.array();
@@ -758,6 +807,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       ftmp1.prefetchToDevice();
       qgdnvtmp1.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Trans);
       AMREX_LAUNCH_DEVICE_LAMBDA(tzybx, ttzybx,
       {
       transy_on_zstates(AMREX_INT_ANYD(ttzybx.loVect()), AMREX_INT_ANYD(ttzybx.hiVect()),
@@ -786,6 +836,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(czbx, 3, fab_qzm, fab_qzp, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(czbx, tczbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tczbx.loVect()), AMREX_INT_ANYD(tczbx.hiVect()),
@@ -798,16 +852,15 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           3, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
       //amrex::Gpu::Device::streamSynchronize();
       
       // [lo(1)-1, lo(2)-1, lo(3)], [hi(1)+1, hi(2)+1, lo(3)]
       const Box& txzbx = amrex::grow(xbx, IntVect(AMREX_D_DECL(0,1,0)));
 
-      qxz.resize(txzbx, QVAR);
-      Elixir elix_qxz = qxz.elixir();
+      scratch.alloc(qxz, txzbx, QVAR);
 
-      qpxz.resize(txzbx, QVAR);
-      Elixir elix_qpxz = qpxz.elixir();
+      scratch.alloc(qpxz, txzbx, QVAR);
 
     const auto fab_qxz = qxz.array();
     const auto fab_qpxz = qpxz.array();
@@ -822,6 +875,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       ftmp1.prefetchToDevice();
       qgdnvtmp1.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Trans);
       AMREX_LAUNCH_DEVICE_LAMBDA(txzbx, ttxzbx,
       {
       transz_on_xstates(AMREX_INT_ANYD(ttxzbx.loVect()), AMREX_INT_ANYD(ttxzbx.hiVect()),
@@ -839,11 +893,9 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       // [lo(1)-1, lo(2), lo(3)], [hi(1)+1, hi(2)+1, lo(3)]
       const Box& tyzbx = amrex::grow(ybx, IntVect(AMREX_D_DECL(1,0,0)));
 
-      qyz.resize(tyzbx, QVAR);
-      Elixir elix_qyz = qyz.elixir();
+      scratch.alloc(qyz, tyzbx, QVAR);
 
-      qpyz.resize(tyzbx, QVAR);
-      Elixir elix_qpyz = qpyz.elixir();
+      scratch.alloc(qpyz, tyzbx, QVAR);
 
       const auto fab_qyz = qyz.array();
       const auto fab_qpyz = qpyz.array();
@@ -859,6 +911,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       ftmp1.prefetchToDevice();
       qgdnvtmp1.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Trans);
       AMREX_LAUNCH_DEVICE_LAMBDA(tyzbx, ttyzbx,
       {
       transz_on_ystates(AMREX_INT_ANYD(ttyzbx.loVect()), AMREX_INT_ANYD(ttyzbx.hiVect()),
@@ -892,6 +945,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(cyzbx, 2, fab_qyz, fab_qpyz, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cyzbx, tcyzbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcyzbx.loVect()), AMREX_INT_ANYD(tcyzbx.hiVect()),
@@ -904,9 +961,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           2, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qyz.clear();
-      elix_qpyz.clear();
+      scratch.release(qyz);
+      scratch.release(qpyz);
 
       // compute F^{z|y}
       // [lo(1)-1, lo(2), lo(3)], [hi(1)+1, hi(2), hi(3)+1]
@@ -924,6 +982,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(czybx, 3, fab_qzy, fab_qpzy, fab_qaux, fab_ftmp2, fab_qgdnvtmp2);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(czybx, tczybx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tczybx.loVect()), AMREX_INT_ANYD(tczybx.hiVect()),
@@ -936,9 +998,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           3, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qzy.clear();
-      elix_qpzy.clear();
+      scratch.release(qzy);
+      scratch.release(qpzy);
 
       qxm.prefetchToDevice();
       qxp.prefetchToDevice();
@@ -953,6 +1016,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       src_q.prefetchToDevice();
 
       // compute the corrected x interface states and fluxes
+      stage_timer.mark(HydroStageTimers::Trans);
       AMREX_LAUNCH_DEVICE_LAMBDA(xbx, txbx,
       {
       transyz(AMREX_INT_ANYD(txbx.loVect()), AMREX_INT_ANYD(txbx.hiVect()),
@@ -969,8 +1033,8 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
               hdt, hdtdy, hdtdz, a_old, a_new);
       });
 
-      elix_qxm.clear();
-      elix_qxp.clear();
+      scratch.release(qxm);
+      scratch.release(qxp);
 
       ql.prefetchToDevice();
       qr.prefetchToDevice();
@@ -980,6 +1044,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(xbx, 1, fab_ql, fab_qr, fab_qaux, fab_flux[0], fab_qe[0]);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(xbx, txbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(txbx.loVect()), AMREX_INT_ANYD(txbx.hiVect()),
@@ -992,6 +1060,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           1, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
       //
       // Use qy?, q?zx, q?xz to compute final y-flux
@@ -1004,6 +1073,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       // ftmp1 = fzx
       // rftmp1 = rfzx
       // qgdnvtmp1 = qgdnvzx
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(czxbx, 3, fab_qzx, fab_qpzx, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(czxbx, tczxbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tczxbx.loVect()), AMREX_INT_ANYD(tczxbx.hiVect()),
@@ -1016,9 +1089,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           3, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qzx.clear();
-      elix_qpzx.clear();
+      scratch.release(qzx);
+      scratch.release(qpzx);
       
       // compute F^{x|z}
       // [lo(1), lo(2)-1, lo(3)], [hi(1)+1, hi(2)+1, hi(3)]
@@ -1036,6 +1110,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(cxzbx, 1, fab_qxz, fab_qpxz, fab_qaux, fab_ftmp2, fab_qgdnvtmp2);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cxzbx, tcxzbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcxzbx.loVect()), AMREX_INT_ANYD(tcxzbx.hiVect()),
@@ -1048,9 +1126,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           1, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qxz.clear();
-      elix_qpxz.clear();
+      scratch.release(qxz);
+      scratch.release(qpxz);
 
       qym.prefetchToDevice();
       qyp.prefetchToDevice();
@@ -1065,6 +1144,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       src_q.prefetchToDevice();
 
       // Compute the corrected y interface states and fluxes
+      stage_timer.mark(HydroStageTimers::Trans);
       AMREX_LAUNCH_DEVICE_LAMBDA(ybx, tybx,
       {
       transxz(AMREX_INT_ANYD(tybx.loVect()), AMREX_INT_ANYD(tybx.hiVect()),
@@ -1081,8 +1161,8 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
               hdt, hdtdx, hdtdz, a_old, a_new);
       });
 
-      elix_qym.clear();
-      elix_qyp.clear();
+      scratch.release(qym);
+      scratch.release(qyp);
 
       // Compute the final F^y
       ql.prefetchToDevice();
@@ -1093,6 +1173,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(ybx, 2, fab_ql, fab_qr, fab_qaux, fab_flux[1], fab_qe[1]);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(ybx, tybx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tybx.loVect()), AMREX_INT_ANYD(tybx.hiVect()),
@@ -1105,6 +1189,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           2, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
       //
       // Use qz?, q?xy, q?yx to compute final z-flux
@@ -1117,6 +1202,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       // ftmp1 = fxy
       // rftmp1 = rfxy
       // qgdnvtmp1 = qgdnvxy
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(cxybx, 1, fab_qxy, fab_qpxy, fab_qaux, fab_ftmp1, fab_qgdnvtmp1);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cxybx, tcxybx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcxybx.loVect()), AMREX_INT_ANYD(tcxybx.hiVect()),
@@ -1129,9 +1218,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           1, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qxy.clear();
-      elix_qpxy.clear();
+      scratch.release(qxy);
+      scratch.release(qpxy);
       
       // compute F^{y|x}
       // [lo(1), lo(2), lo(3)-1], [hi(1), hi(2)+dg(2), hi(3)+1]
@@ -1149,6 +1239,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(cyxbx, 2, fab_qyx, fab_qpyx, fab_qaux, fab_ftmp2, fab_qgdnvtmp2);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(cyxbx, tcyxbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tcyxbx.loVect()), AMREX_INT_ANYD(tcyxbx.hiVect()),
@@ -1161,9 +1255,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           BL_ARR4_TO_FORTRAN_3D(fab_shk),
                           2, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
       });
+      }
 
-      elix_qyx.clear();
-      elix_qpyx.clear();
+      scratch.release(qyx);
+      scratch.release(qpyx);
       
       qzm.prefetchToDevice();
       qzp.prefetchToDevice();
@@ -1178,6 +1273,7 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       src_q.prefetchToDevice();
 
       // compute the corrected z interface states and fluxes
+      stage_timer.mark(HydroStageTimers::Trans);
       AMREX_LAUNCH_DEVICE_LAMBDA(zbx, tzbx,
       {
       transxy(AMREX_INT_ANYD(tzbx.loVect()), AMREX_INT_ANYD(tzbx.hiVect()),
@@ -1194,13 +1290,13 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
               hdt, hdtdx, hdtdy, a_old, a_new);
       });
 
-      elix_src_q.clear();
-      elix_qzm.clear();
-      elix_qzp.clear();
-      elix_ftmp1.clear();
-      elix_ftmp2.clear();
-      elix_qgdnvtmp1.clear();
-      elix_qgdnvtmp2.clear();
+      scratch.release(src_q);
+      scratch.release(qzm);
+      scratch.release(qzp);
+      scratch.release(ftmp1);
+      scratch.release(ftmp2);
+      scratch.release(qgdnvtmp1);
+      scratch.release(qgdnvtmp2);
         
       // compute the final z fluxes F^z
 
@@ -1212,6 +1308,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qaux.prefetchToDevice();
       shk.prefetchToDevice();
 
+      stage_timer.mark(HydroStageTimers::Riemann);
+      if (riemann_batched) {
+        cmpflx_rows(zbx, 3, fab_ql, fab_qr, fab_qaux, fab_flux[2], fab_qe[2]);
+      } else {
       AMREX_LAUNCH_DEVICE_LAMBDA(zbx, tzbx,
       {
       cmpflx_plus_godunov(AMREX_INT_ANYD(tzbx.loVect()), AMREX_INT_ANYD(tzbx.hiVect()),
@@ -1225,12 +1325,15 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                           3, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
 
       });
+      }
+
+      scratch.release(qaux);
+      scratch.release(q_int);
+      scratch.release(ql);
+      scratch.release(qr);
+      scratch.release(shk);
 
-      elix_qaux.clear();
-      elix_q_int.clear();
-      elix_ql.clear();
-      elix_qr.clear();
-      elix_shk.clear();
+      stage_timer.mark(HydroStageTimers::Consup);
 
       // clean the fluxes
       Sborder[mfi].prefetchToDevice();
@@ -1260,11 +1363,13 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
 
       }
 
-      elix_div.clear();
+      scratch.release(div);
 
+      // Faces next to skipped tiles take the flux those tiles use
+      if (hydro_skip_tol > 0)
+          hydro_skip_face_fluxes(bx, Sborder[mfi], skip_mask[mfi], flux, qe, dx.data(), dt);
 
-      pdivu.resize(bx, 1);
-      Elixir elix_pdivu = pdivu.elixir();
+      scratch.alloc(pdivu, bx, 1);
     const auto fab_pdivu = pdivu.array();
 
       Sborder[mfi].prefetchToDevice();
@@ -1277,7 +1382,11 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
       qe[2].prefetchToDevice();
       pdivu.prefetchToDevice();
 
-      
+
+      if (hydro_specialize)
+        consup_spec(bx, fab_Sborder, fab_hydro_source, fab_flux, fab_qe,
+                    dx.data(), dt, a_old, a_new);
+      else
       AMREX_LAUNCH_DEVICE_LAMBDA(bx, tbx,
       {
       ca_consup(AMREX_INT_ANYD(tbx.loVect()), AMREX_INT_ANYD(tbx.hiVect()),
@@ -1293,10 +1402,10 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
                 dx.data(),dt,a_old,a_new);
             });
 
-      elix_qe_x.clear();
-      elix_qe_y.clear();
-      elix_qe_z.clear();
-      elix_pdivu.clear();
+      scratch.release(qe[0]);
+      scratch.release(qe[1]);
+      scratch.release(qe[2]);
+      scratch.release(pdivu);
 
       for (int idir = 0; idir < AMREX_SPACEDIM; ++idir) {
 
@@ -1322,33 +1431,49 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
 
       if(finest_level!=0)
         {
-        Array4<Real> const flux_fab = (flux[idir]).array();
-        Array4<Real> fluxes_fab = (fluxes[idir]).array(mfi);
-        const int numcomp = NUM_STATE;
-        fluxes[idir][mfi].prefetchToDevice();
         flux[idir].prefetchToDevice();
-
-            AMREX_HOST_DEVICE_FOR_4D(mfi.nodaltilebox(idir), numcomp, i, j, k, n,
-            {
-                fluxes_fab(i,j,k,n) += flux_fab(i,j,k,n);
-            });
+        fluxes.store(mfi, bx, idir, flux[idir]);
         }
       } // idir loop
 
-      elix_flux_x.clear();
-      elix_flux_y.clear();
-      elix_flux_z.clear();
+      scratch.release(flux[0]);
+      scratch.release(flux[1]);
+      scratch.release(flux[2]);
 
       //took out track_grid_losses
       //amrex::Gpu::Device::synchronize();
+      } // pass boxes loop
     } // MFIter loop
 
+    // Views into the arena do not outlive the loop
+    scratch.reset();
+
 
   } // OMP loop
 
+  } // pass loop
+
   ////  amrex::Gpu::Device::streamSynchronize();
   BL_PROFILE_VAR_STOP(CA_UMDRV);
 
+  if (verbose > 1 && npasses == 2)
+    {
+      ParallelDescriptor::ReduceLongSum(ncells_overlapped, ParallelDescriptor::IOProcessorNumber());
+      if (ParallelDescriptor::IOProcessor())
+        std::cout << "... " << ncells_overlapped << " of " << grids.numPts()
+                  << " cells advanced during the ghost-cell exchange" << std::endl;
+    }
+
+  if (hydro_skip_tol > 0 && hydro_skip_check)
+      hydro_skip_conservation_check(Sborder, hydro_source, dt, a_old, a_new);
+
+  if (verbose > 1 && hydro_skip_tol > 0)
+    {
+      ParallelDescriptor::ReduceIntSum(ntiles_skipped, ParallelDescriptor::IOProcessorNumber());
+      if (ParallelDescriptor::IOProcessor())
+        std::cout << "... " << ntiles_skipped << " quiescent tiles skipped" << std::endl;
+    }
+
   if (verbose && ParallelDescriptor::IOProcessor())
     std::cout << "... Leaving construct_ctu_hydro_sources()" << std::endl << std::endl;
 
@@ -1372,18 +1497,8 @@ Nyx::construct_ctu_hydro_source(amrex::Real time, amrex::Real dt, amrex::Real a_
   // These seem to check if the provided flux is a gpuptr, and use launches
     if (add_to_flux_register && finest_level!=0)
     {
-       if (do_reflux) {
-         if (current) {
-           for (int i = 0; i < BL_SPACEDIM ; i++) {
-             current->FineAdd(fluxes[i], i, 0, 0, NUM_STATE, 1);
-           }
-         }
-         if (fine) {
-           for (int i = 0; i < BL_SPACEDIM ; i++) {
-                 fine->CrseInit(fluxes[i],i,0,0,NUM_STATE,-1.,FluxRegister::ADD);
-           }
-         }
-       }
+       if (do_reflux)
+         fluxes.add_to_registers(current, fine);
     }
 
 }
@@ -0,0 +1,108 @@
+#include "Nyx.H"
+#include "Nyx_F.H"
+
+using namespace amrex;
+
+//
+// Fused form of the first CTU stages for one tile: cons -> prim, the source
+// conversion, flattening, the three PLM traces and divu.  Instead of sweeping
+// the whole tile once per stage, the tile is walked in slabs of `slab` planes
+// in z, and each slab goes through every stage before the next one starts, so
+// the q, flatn and dq planes a stage reads were written moments before and are
+// still in cache.
+//
+// Flattening reads q three planes above the cell and the slopes two, so the
+// primitive conversion runs ahead of the slab by three planes; it never
+// recomputes a plane.  The results are identical to the unfused sweeps.
+//
+void
+Nyx::ctu_slab_states (const Box& bx, int slab,
+                      const FArrayBox& Sborder, const FArrayBox& grav,
+                      const FArrayBox& ext_src,
+                      FArrayBox& q, FArrayBox& qaux, FArrayBox& src_q,
+                      FArrayBox& flatn, FArrayBox& shk, FArrayBox& dq,
+                      FArrayBox& qxm, FArrayBox& qxp,
+                      FArrayBox& qym, FArrayBox& qyp,
+                      FArrayBox& qzm, FArrayBox& qzp,
+                      FArrayBox& div,
+                      const Real* dx, Real dt, Real a_old, Real a_new,
+                      const int* domain_lo, const int* domain_hi)
+{
+#ifdef AMREX_USE_GPU
+    amrex::Abort("Nyx::ctu_slab_states is a CPU-only path");
+#else
+    BL_PROFILE("Nyx::ctu_slab_states()");
+
+    const Box& qbx = amrex::grow(bx, NUM_GROW);
+    const Box& obx = amrex::grow(bx, 1);
+
+    FArrayBox* qm[3] = {&qxm, &qym, &qzm};
+    FArrayBox* qp[3] = {&qxp, &qyp, &qzp};
+
+    // Last z plane of q, qaux and src_q filled so far
+    int kq_done = qbx.smallEnd(2) - 1;
+
+    for (int k0 = obx.smallEnd(2); k0 <= obx.bigEnd(2); k0 += slab)
+    {
+        const int k1 = std::min(k0 + slab - 1, obx.bigEnd(2));
+
+        const int kq = std::min(k1 + 3, qbx.bigEnd(2));
+        if (kq > kq_done)
+        {
+            Box pbx(qbx);
+            pbx.setSmall(2, kq_done + 1);
+            pbx.setBig(2, kq);
+
+            ca_ctoprim(AMREX_INT_ANYD(pbx.loVect()), AMREX_INT_ANYD(pbx.hiVect()),
+                       BL_TO_FORTRAN_ANYD(Sborder),
+                       BL_TO_FORTRAN_ANYD(q),
+                       BL_TO_FORTRAN_ANYD(qaux));
+
+            ca_srctoprim(AMREX_INT_ANYD(pbx.loVect()), AMREX_INT_ANYD(pbx.hiVect()),
+                         BL_TO_FORTRAN_ANYD(q),
+                         BL_TO_FORTRAN_ANYD(qaux),
+                         BL_TO_FORTRAN_ANYD(grav),
+                         BL_TO_FORTRAN_ANYD(ext_src),
+                         BL_TO_FORTRAN_ANYD(src_q),
+                         a_old, a_new, dt);
+
+            kq_done = kq;
+        }
+
+        Box sbx(obx);
+        sbx.setSmall(2, k0);
+        sbx.setBig(2, k1);
+
+        if (use_flattening == 1) {
+            ca_uflatten(AMREX_INT_ANYD(sbx.loVect()), AMREX_INT_ANYD(sbx.hiVect()),
+                        BL_TO_FORTRAN_ANYD(q),
+                        BL_TO_FORTRAN_ANYD(flatn),
+                        QPRES);
+        } else {
+            flatn.setVal(1.0, sbx, 0, 1);
+        }
+
+        for (int idir = 1; idir <= 3; ++idir)
+        {
+            ctu_plm_states(AMREX_INT_ANYD(sbx.loVect()), AMREX_INT_ANYD(sbx.hiVect()),
+                           idir, AMREX_INT_ANYD(bx.loVect()), AMREX_INT_ANYD(bx.hiVect()),
+                           BL_TO_FORTRAN_ANYD(q),
+                           BL_TO_FORTRAN_ANYD(flatn),
+                           BL_TO_FORTRAN_ANYD(qaux),
+                           BL_TO_FORTRAN_ANYD(src_q),
+                           BL_TO_FORTRAN_ANYD(shk),
+                           BL_TO_FORTRAN_ANYD(dq),
+                           BL_TO_FORTRAN_ANYD(*qm[idir-1]),
+                           BL_TO_FORTRAN_ANYD(*qp[idir-1]),
+                           dx, dt,
+                           a_old, a_new,
+                           AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
+        }
+
+        divu(AMREX_INT_ANYD(sbx.loVect()), AMREX_INT_ANYD(sbx.hiVect()),
+             BL_TO_FORTRAN_ANYD(q),
+             dx,
+             BL_TO_FORTRAN_ANYD(div));
+    }
+#endif
+}
@@ -0,0 +1,151 @@
+#include "Nyx.H"
+#include "Nyx_F.H"
+#include "Nyx_hydro_kernels.H"
+
+using namespace amrex;
+
+//
+// Specialized CTU kernels (nyx.hydro_specialize = 1). hydro_kernels_init
+// reads the method options once per level advance and points the kernels
+// below at the variants of Nyx_hydro_kernels.H instantiated for them, so
+// the tile loop calls them with no further tests on the options.
+//
+
+namespace
+{
+    constexpr int max_pass = 32;
+
+    HydroKernelParams hydro_params;
+    int qpass[max_pass];
+
+    using TraceKernel = void (*)(const Box&, const Box&,
+                                 Array4<Real const> const&, Array4<Real const> const&,
+                                 Array4<Real const> const&, Array4<Real const> const&,
+                                 Array4<Real> const&, Array4<Real> const&,
+                                 Real, Real, Real, const HydroKernelParams&);
+
+    using ConsupKernel = void (*)(const Box&,
+                                  Array4<Real const> const&, Array4<Real> const&,
+                                  Array4<Real const> const&, Array4<Real const> const&,
+                                  Array4<Real const> const&, Array4<Real const> const&,
+                                  Array4<Real const> const&, Array4<Real const> const&,
+                                  const Real*, Real, Real, Real, const HydroKernelParams&);
+
+    TraceKernel  trace_kernel[3] = {nullptr, nullptr, nullptr};
+    ConsupKernel consup_kernel   = nullptr;
+
+    template <int Opts>
+    void
+    select_kernels ()
+    {
+        trace_kernel[0] = &plm_trace<0,Opts>;
+        trace_kernel[1] = &plm_trace<1,Opts>;
+        trace_kernel[2] = &plm_trace<2,Opts>;
+        consup_kernel   = &consup<Opts>;
+    }
+}
+
+void
+Nyx::hydro_kernels_init ()
+{
+    Real gamma_in;
+    int solver, hybrid, analriem, csmall_gamma, gamma_minus, npass;
+    int upass[max_pass];
+
+    fort_get_riemann_params(&gamma_in, &hydro_params.small_dens, &hydro_params.small_pres,
+                            &solver, &hybrid, &analriem, &csmall_gamma, &gamma_minus,
+                            &max_pass, &npass, qpass, upass);
+
+    int iorder, pslope, src_in_trace, pressure_law, area_dt;
+    fort_get_hydro_kernel_params(&iorder, &pslope, &gamma_minus, &src_in_trace,
+                                 &pressure_law, &area_dt);
+
+    if (pslope != 0)
+        amrex::Abort("Nyx::hydro_specialize does not implement use_pslope = 1");
+    if (npass > max_pass)
+        amrex::Abort("Nyx::hydro_specialize: too many passively advected quantities");
+
+    hydro_params.gamma_minus_1 = gamma_in - 1.0;
+    hydro_params.iorder = iorder;
+    hydro_params.npass  = npass;
+    hydro_params.qpass  = qpass;
+    hydro_params.nqsrc  = NQSRC;
+    hydro_params.urho   = Density;
+    hydro_params.umx    = Xmom;
+    hydro_params.ueden  = Eden;
+    hydro_params.ueint  = Eint;
+    hydro_params.nvar   = NUM_STATE;
+    hydro_params.opts   = (gamma_minus  ? HydroOpt::GammaMinus       : 0)
+                        | (src_in_trace ? HydroOpt::SrcQInTrace      : 0)
+                        | (pressure_law ? HydroOpt::PressureLawPdivu : 0)
+                        | (area_dt      ? HydroOpt::AreaDtScale      : 0);
+
+    switch (hydro_params.opts)
+    {
+    case  0: select_kernels< 0>(); break;
+    case  1: select_kernels< 1>(); break;
+    case  2: select_kernels< 2>(); break;
+    case  3: select_kernels< 3>(); break;
+    case  4: select_kernels< 4>(); break;
+    case  5: select_kernels< 5>(); break;
+    case  6: select_kernels< 6>(); break;
+    case  7: select_kernels< 7>(); break;
+    case  8: select_kernels< 8>(); break;
+    case  9: select_kernels< 9>(); break;
+    case 10: select_kernels<10>(); break;
+    case 11: select_kernels<11>(); break;
+    case 12: select_kernels<12>(); break;
+    case 13: select_kernels<13>(); break;
+    case 14: select_kernels<14>(); break;
+    default: select_kernels<15>(); break;
+    }
+}
+
+//
+// Same results as ctu_plm_states in direction idir (1, 2 or 3) on the cells
+// of bx, with vbx the valid box
+//
+void
+Nyx::ctu_plm_states_spec (const Box& bx, const Box& vbx, int idir,
+                          Array4<Real const> const& q, Array4<Real const> const& flatn,
+                          Array4<Real const> const& qaux, Array4<Real const> const& srcQ,
+                          Array4<Real> const& shk, Array4<Real> const& dq,
+                          Array4<Real> const& qm, Array4<Real> const& qp,
+                          const Real* dx, Real dt, Real a_old)
+{
+    BL_PROFILE("Nyx::ctu_plm_states_spec()");
+
+    const HydroKernelParams& hp = hydro_params;
+
+    AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k, { shk(i,j,k) = 0.0; });
+
+    // Only the components the trace reads
+    for (int m = -6; m < hp.npass; ++m)
+    {
+        const int n = (m < 0) ? m + 6 : hp.qpass[m];
+
+        switch (idir)
+        {
+        case 1:  plm_slopes<0>(bx, n, hp.iorder, q, flatn, dq); break;
+        case 2:  plm_slopes<1>(bx, n, hp.iorder, q, flatn, dq); break;
+        default: plm_slopes<2>(bx, n, hp.iorder, q, flatn, dq); break;
+        }
+    }
+
+    const Real dtdx = dt/(dx[idir-1]*a_old);
+
+    trace_kernel[idir-1](bx, vbx, q, qaux, dq, srcQ, qm, qp, dtdx, dt, a_old, hp);
+}
+
+// Same results as ca_consup on bx, up to rounding
+void
+Nyx::consup_spec (const Box& bx, Array4<Real const> const& S, Array4<Real> const& hydro_src,
+                  GpuArray<Array4<Real>, AMREX_SPACEDIM> const& flux,
+                  GpuArray<Array4<Real>, AMREX_SPACEDIM> const& qe,
+                  const Real* dx, Real dt, Real a_old, Real a_new)
+{
+    BL_PROFILE("Nyx::consup_spec()");
+
+    consup_kernel(bx, S, hydro_src, flux[0], flux[1], flux[2], qe[0], qe[1], qe[2],
+                  dx, dt, a_old, a_new, hydro_params);
+}
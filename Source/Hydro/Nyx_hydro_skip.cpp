@@ -0,0 +1,367 @@
+#include "Nyx.H"
+#include "Nyx_F.H"
+#include "HydroScratch.H"
+#include "BoundaryFluxes.H"
+
+#include <AMReX_iMultiFab.H>
+
+#define BL_ARR4_TO_FORTRAN_3D(a) a.p,&((a).begin.x),amrex::GpuArray<int,3>{(a).end.x-1,(a).end.y-1,(a).end.z-1}.data()
+#define BL_ARR4_TO_FORTRAN(a) (a).p, AMREX_ARLIM(&((a).begin.x)), (a).end.x-1,(a).end.y-1,(a).end.z-1
+
+using namespace amrex;
+
+//
+// Skipping the hydro on quiescent tiles (nyx.hydro_skip_tol > 0, with
+// nyx.hydro_convert = 1).
+//
+// A tile is quiescent if every cell its hydro stencil reads (the tile grown
+// by NUM_GROW) is within hydro_skip_dens_factor of small_dens, and over those
+// cells the spread of the density and of rho e (the pressure, for the gamma
+// law) is at most hydro_skip_tol times their minimum, and each velocity
+// component is at most hydro_skip_tol times the smallest sound speed, in
+// size as well as in spread. The state is then uniform and nearly at rest to
+// that tolerance.
+//
+// A tile is skipped only if it and every tile it shares a face with are
+// quiescent (exchanged across grids and periodic boundaries; a tile at a
+// physical or coarse/fine boundary is never skipped), and none of its faces
+// go to the flux registers. hydro_quiescent_mask marks the cells of the
+// skipped tiles. For such a tile the drivers skip the primitive variables,
+// reconstruction and Riemann solves, and ca_consup is given the flux of the
+// mean state of the two cells on each face, with the Godunov velocity and
+// pressure of that state; the expansion and p div u terms are then those of
+// the (nearly uniform) state.
+//
+// A tile that is not skipped computes its fluxes as usual, and then
+// hydro_skip_face_fluxes replaces them on its faces next to a skipped cell
+// with the same mean-state flux. Every face then has one flux for both of
+// its cells, so the update is conservative; nyx.hydro_skip_check = 1 checks
+// this on level 0 of a periodic domain (hydro_skip_conservation_check).
+//
+
+namespace
+{
+    // use_area_dt_scale_apply, read by hydro_quiescent_mask
+    int skip_area_dt = 1;
+
+    // flux and Godunov state of the mean of the two cells on the face (i,j,k)
+    // in direction idir; the flux is times scale
+    void
+    mean_face_flux (int i, int j, int k, int idir, Array4<Real const> const& u,
+                    Array4<Real> const& f, Array4<Real> const& q,
+                    int nstate, Real gamma_minus_1, Real scale)
+    {
+        const int di = (idir == 0), dj = (idir == 1), dk = (idir == 2);
+
+        const Real rho = 0.5*(u(i-di,j-dj,k-dk,Density) + u(i,j,k,Density));
+        const Real vel[3] = {
+            0.5*(u(i-di,j-dj,k-dk,Xmom) + u(i,j,k,Xmom)) / rho,
+            0.5*(u(i-di,j-dj,k-dk,Ymom) + u(i,j,k,Ymom)) / rho,
+            0.5*(u(i-di,j-dj,k-dk,Zmom) + u(i,j,k,Zmom)) / rho};
+        const Real pres = gamma_minus_1 * 0.5*(u(i-di,j-dj,k-dk,Eint) + u(i,j,k,Eint));
+        const Real un = vel[idir];
+
+        for (int n = 0; n < nstate; ++n)
+            f(i,j,k,n) = 0.5*(u(i-di,j-dj,k-dk,n) + u(i,j,k,n)) * un;
+
+        f(i,j,k,Xmom+idir) += pres;
+        f(i,j,k,Eden)      += pres * un;
+
+        for (int n = 0; n < nstate; ++n)
+            f(i,j,k,n) *= scale;
+
+        for (int n = 0; n < q.nComp(); ++n)
+            q(i,j,k,n) = 0.0;
+
+        q(i,j,k,Nyx::GDRHO-1)  = rho;
+        q(i,j,k,Nyx::GDU-1)    = vel[0];
+        q(i,j,k,Nyx::GDV-1)    = vel[1];
+        q(i,j,k,Nyx::GDW-1)    = vel[2];
+        q(i,j,k,Nyx::GDPRES-1) = pres;
+    }
+}
+
+// True if the hydro stencil of the tile bx of S is quiescent (see above)
+bool
+Nyx::hydro_tile_quiescent (const Box& bx, const FArrayBox& S)
+{
+    const Box& gbx = amrex::grow(bx, NUM_GROW);
+    const auto u = S.const_array();
+    const auto lo = amrex::lbound(gbx);
+    const auto hi = amrex::ubound(gbx);
+
+    const Real rho_cut = hydro_skip_dens_factor * small_dens;
+
+    Real rho_min  = std::numeric_limits<Real>::max(), rho_max  = 0.0;
+    Real rhoe_min = std::numeric_limits<Real>::max(), rhoe_max = -std::numeric_limits<Real>::max();
+    Real vel_min[3], vel_max[3];
+    for (int d = 0; d < 3; ++d)
+    {
+        vel_min[d] =  std::numeric_limits<Real>::max();
+        vel_max[d] = -std::numeric_limits<Real>::max();
+    }
+
+    for (int k = lo.z; k <= hi.z; ++k)
+    {
+        for (int j = lo.y; j <= hi.y; ++j)
+        {
+            for (int i = lo.x; i <= hi.x; ++i)
+            {
+                const Real rho = u(i,j,k,Density);
+
+                // Most tiles that are not quiescent stop at their first cell
+                if (rho > rho_cut || rho <= 0.0) return false;
+
+                const Real rhoe    = u(i,j,k,Eint);
+                const Real rhoinv  = 1.0 / rho;
+
+                rho_min  = std::min(rho_min, rho);
+                rho_max  = std::max(rho_max, rho);
+                rhoe_min = std::min(rhoe_min, rhoe);
+                rhoe_max = std::max(rhoe_max, rhoe);
+
+                for (int d = 0; d < 3; ++d)
+                {
+                    const Real vel = u(i,j,k,Xmom+d) * rhoinv;
+                    vel_min[d] = std::min(vel_min[d], vel);
+                    vel_max[d] = std::max(vel_max[d], vel);
+                }
+            }
+        }
+    }
+
+    if (rhoe_min <= 0.0) return false;
+    if (rho_max  - rho_min  > hydro_skip_tol * rho_min)  return false;
+    if (rhoe_max - rhoe_min > hydro_skip_tol * rhoe_min) return false;
+
+    // A lower bound on the sound speed over the stencil
+    const Real c_min = std::sqrt(gamma * (gamma - 1.0) * rhoe_min / rho_max);
+
+    // |u| << c as well as a small spread, so the advective fluxes are small
+    for (int d = 0; d < 3; ++d)
+    {
+        if (vel_max[d] - vel_min[d] > hydro_skip_tol * c_min) return false;
+        if (std::max(vel_max[d], -vel_min[d]) > hydro_skip_tol * c_min) return false;
+    }
+
+    return true;
+}
+
+// mask = 1 on the cells (valid and one ghost cell) of the tiles of S that are
+// skipped; fluxes, if given, are those the driver stores for the registers
+void
+Nyx::hydro_quiescent_mask (const MultiFab& S, iMultiFab& mask, const BoundaryFluxes* fluxes)
+{
+    BL_PROFILE("Nyx::hydro_quiescent_mask()");
+
+    int iorder, pslope, gamma_minus, src_in_trace, pressure_law;
+    fort_get_hydro_kernel_params(&iorder, &pslope, &gamma_minus, &src_in_trace,
+                                 &pressure_law, &skip_area_dt);
+
+    // 1 on the quiescent tiles first
+    iMultiFab quiescent(S.boxArray(), S.DistributionMap(), 1, 1);
+    quiescent.setVal(0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(S, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+
+        if (hydro_tile_quiescent(bx, S[mfi]))
+            quiescent[mfi].setVal<RunOn::Host>(1, bx);
+    }
+
+    quiescent.FillBoundary(geom.periodicity());
+
+    // then on the tiles that are quiescent with all their face neighbours
+    mask.define(S.boxArray(), S.DistributionMap(), 1, 1);
+    mask.setVal(0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(S, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+
+        if (fluxes && fluxes->stores(mfi)) continue;
+
+        const Box& gbx = amrex::grow(bx, 1);
+        const auto q  = quiescent[mfi].const_array();
+        const auto lo = amrex::lbound(gbx);
+        const auto hi = amrex::ubound(gbx);
+
+        bool skip = true;
+        for (int k = lo.z; k <= hi.z && skip; ++k)
+            for (int j = lo.y; j <= hi.y && skip; ++j)
+                for (int i = lo.x; i <= hi.x && skip; ++i)
+                    if (q(i,j,k) == 0) skip = false;
+
+        if (skip)
+            mask[mfi].setVal<RunOn::Host>(1, bx);
+    }
+
+    mask.FillBoundary(geom.periodicity());
+}
+
+// True if the tile of mfi is skipped
+bool
+Nyx::hydro_tile_skip (const MFIter& mfi, const iMultiFab& mask)
+{
+    return mask[mfi](mfi.tilebox().smallEnd()) == 1;
+}
+
+// On the faces of the tile bx next to a skipped cell, replace flux and qe with
+// the mean-state flux the skipped tile uses there
+void
+Nyx::hydro_skip_face_fluxes (const Box& bx, const FArrayBox& S, const IArrayBox& mask,
+                             FArrayBox flux[], FArrayBox qe[], const Real* dx, Real dt)
+{
+    const auto u = S.const_array();
+    const auto m = mask.const_array();
+    const Real area[3] = {dx[1]*dx[2], dx[0]*dx[2], dx[0]*dx[1]};
+
+    for (int idir = 0; idir < AMREX_SPACEDIM; ++idir)
+    {
+        const auto f = flux[idir].array();
+        const auto q = qe[idir].array();
+        const int  di = (idir == 0), dj = (idir == 1), dk = (idir == 2);
+        const Real scale = skip_area_dt ? area[idir] * dt : 1.0;
+
+        // The lo and hi faces of the tile; the cells of the tile itself are
+        // not skipped, so only the cell outside can be
+        for (const Box& fbx : {amrex::bdryLo(bx, idir), amrex::bdryHi(bx, idir)})
+        {
+            const auto lo = amrex::lbound(fbx);
+            const auto hi = amrex::ubound(fbx);
+
+            for (int k = lo.z; k <= hi.z; ++k)
+                for (int j = lo.y; j <= hi.y; ++j)
+                    for (int i = lo.x; i <= hi.x; ++i)
+                        if (m(i-di,j-dj,k-dk) == 1 || m(i,j,k) == 1)
+                            mean_face_flux(i, j, k, idir, u, f, q, NUM_STATE,
+                                           gamma - 1.0, scale);
+        }
+    }
+}
+
+// hydro_src on the skipped tile bx: ca_consup with the fluxes of the mean
+// state on each face
+void
+Nyx::hydro_quiescent_source (const Box& bx, const FArrayBox& S, FArrayBox& hydro_src,
+                             const Real* dx, Real dt, Real a_old, Real a_new)
+{
+    HydroScratch& scratch = HydroScratch::get();
+
+    FArrayBox flux[AMREX_SPACEDIM];
+    FArrayBox qe[AMREX_SPACEDIM];
+    FArrayBox pdivu;
+
+    const auto u = S.const_array();
+    const Real area[3] = {dx[1]*dx[2], dx[0]*dx[2], dx[0]*dx[1]};
+
+    for (int idir = 0; idir < AMREX_SPACEDIM; ++idir)
+    {
+        const Box& nbx = amrex::surroundingNodes(bx, idir);
+        scratch.alloc(flux[idir], nbx, NUM_STATE);
+        scratch.alloc(qe[idir], nbx, NGDNV);
+
+        const auto f  = flux[idir].array();
+        const auto q  = qe[idir].array();
+        const auto lo = amrex::lbound(nbx);
+        const auto hi = amrex::ubound(nbx);
+
+        const Real scale = skip_area_dt ? area[idir] * dt : 1.0;
+
+        for (int k = lo.z; k <= hi.z; ++k)
+            for (int j = lo.y; j <= hi.y; ++j)
+                for (int i = lo.x; i <= hi.x; ++i)
+                    mean_face_flux(i, j, k, idir, u, f, q, NUM_STATE,
+                                   gamma - 1.0, scale);
+    }
+    scratch.alloc(pdivu, bx, 1);
+
+    const auto fab_S         = S.const_array();
+    const auto fab_hydro_src = hydro_src.array();
+    const auto fab_pdivu     = pdivu.array();
+
+    GpuArray<Array4<Real>, AMREX_SPACEDIM> fab_flux{
+      AMREX_D_DECL(flux[0].array(), flux[1].array(), flux[2].array())};
+    GpuArray<Array4<Real>, AMREX_SPACEDIM> fab_qe{
+      AMREX_D_DECL(qe[0].array(), qe[1].array(), qe[2].array())};
+
+    ca_consup(AMREX_INT_ANYD(bx.loVect()), AMREX_INT_ANYD(bx.hiVect()),
+              BL_ARR4_TO_FORTRAN(fab_S),
+              BL_ARR4_TO_FORTRAN(fab_hydro_src),
+              BL_ARR4_TO_FORTRAN(fab_flux[0]),
+              BL_ARR4_TO_FORTRAN(fab_flux[1]),
+              BL_ARR4_TO_FORTRAN(fab_flux[2]),
+              BL_ARR4_TO_FORTRAN_3D(fab_qe[0]),
+              BL_ARR4_TO_FORTRAN_3D(fab_qe[1]),
+              BL_ARR4_TO_FORTRAN_3D(fab_qe[2]),
+              BL_ARR4_TO_FORTRAN_3D(fab_pdivu),
+              dx,dt,a_old,a_new);
+
+    scratch.release(pdivu);
+    for (int idir = AMREX_SPACEDIM-1; idir >= 0; --idir)
+    {
+        scratch.release(qe[idir]);
+        scratch.release(flux[idir]);
+    }
+}
+
+// nyx.hydro_skip_check: the net mass and (rho E) hydro_src adds to this level
+// (without the expansion term of (rho E)). On level 0 of a periodic domain
+// the face fluxes cancel in these sums, so both must vanish to roundoff
+void
+Nyx::hydro_skip_conservation_check (const MultiFab& S, const MultiFab& hydro_src,
+                                    Real dt, Real a_old, Real a_new)
+{
+    if (level != 0 || !geom.isAllPeriodic()) return;
+
+    BL_PROFILE("Nyx::hydro_skip_conservation_check()");
+
+    const Real a_half  = 0.5 * (a_old + a_new);
+    const Real exp_fac = a_half * (a_new - a_old) * (2.0 - 3.0 * (gamma - 1.0))
+                         / (skip_area_dt ? dt : 1.0);
+
+    // net mass, sum of |mass|, net energy, sum of |energy|
+    Real mass = 0.0, mass_abs = 0.0, eden = 0.0, eden_abs = 0.0;
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:mass,mass_abs,eden,eden_abs)
+#endif
+    for (MFIter mfi(hydro_src, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto u   = S.const_array(mfi);
+        const auto src = hydro_src.const_array(mfi);
+        const auto lo  = amrex::lbound(bx);
+        const auto hi  = amrex::ubound(bx);
+
+        for (int k = lo.z; k <= hi.z; ++k)
+            for (int j = lo.y; j <= hi.y; ++j)
+                for (int i = lo.x; i <= hi.x; ++i)
+                {
+                    const Real dm = src(i,j,k,Density);
+                    const Real de = src(i,j,k,Eden) - exp_fac * u(i,j,k,Eint);
+                    mass     += dm;
+                    mass_abs += std::abs(dm);
+                    eden     += de;
+                    eden_abs += std::abs(de);
+                }
+    }
+
+    Real sums[4] = {mass, mass_abs, eden, eden_abs};
+    ParallelDescriptor::ReduceRealSum(sums, 4);
+
+    if (verbose && ParallelDescriptor::IOProcessor())
+        std::cout << "... hydro_skip_check: net mass " << sums[0] << " of " << sums[1]
+                  << ", net (rho E) " << sums[2] << " of " << sums[3] << std::endl;
+
+    const Real tol = 1.e-10;
+    if (std::abs(sums[0]) > tol * sums[1] || std::abs(sums[2]) > tol * sums[3])
+        amrex::Abort("Nyx::hydro_skip_check: the hydro update with skipped tiles is not conservative");
+}
@@ -0,0 +1,445 @@
+#include "Nyx.H"
+#include "Nyx_F.H"
+#include "HydroScratch.H"
+#include "HydroStageTimers.H"
+#include "BoundaryFluxes.H"
+#include "Nyx_hydro_kernels.H"
+
+#define BL_ARR4_TO_FORTRAN_3D(a) a.p,&((a).begin.x),amrex::GpuArray<int,3>{(a).end.x-1,(a).end.y-1,(a).end.z-1}.data()
+#define BL_ARR4_TO_FORTRAN(a) (a).p, AMREX_ARLIM(&((a).begin.x)), (a).end.x-1,(a).end.y-1,(a).end.z-1
+
+using namespace amrex;
+
+//
+// Method-of-lines hydro (nyx.hydro_mol = 1, with nyx.hydro_convert = 1).
+//
+// Each stage reconstructs the primitive state to the faces with PLM
+// (ppm_type = 0) or PPM (ppm_type = 1) in each direction separately, solves
+// one Riemann problem per face and takes the flux divergence with ca_consup.
+// There is no characteristic tracing, no source terms in the face states and
+// no transverse corrections. The stages are combined as in Heun's method
+// (second-order SSP Runge-Kutta):
+//
+//   U*      = update_state_with_sources(U^n, L(U^n))
+//   hydro_src = (L(U^n) + L(U*)) / 2
+//
+// so the caller's update_state_with_sources with this hydro_src gives
+// U^{n+1} = (U^n + U* + dt L(U*)) / 2 plus the old-time sources. The fluxes
+// given to the flux registers are the average of the two stages.
+//
+
+namespace
+{
+    // van Leer slope of ca_ppm_reconstruct at s0
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real
+    vl_slope (Real sl, Real s0, Real sr)
+    {
+        const Real dl = 2.0*(s0 - sl);
+        const Real dr = 2.0*(sr - s0);
+        if (dl*dr <= 0.0) return 0.0;
+        const Real dc = 0.5*(sr - sl);
+        return std::copysign(amrex::min(std::abs(dc), amrex::min(std::abs(dl), std::abs(dr))), dc);
+    }
+}
+
+void
+Nyx::mol_reconstruct (const Box& bx, int idir, int ppm,
+                      Array4<Real const> const& q, Array4<Real const> const& flatn,
+                      Array4<Real> const& qm, Array4<Real> const& qp)
+{
+    // Every cell from one below to one above bx in idir gives the right
+    // state of its lower face and the left state of its upper face; only
+    // the faces of bx are kept
+    const Box& cbx = amrex::grow(bx, idir, 1);
+    const int lo = bx.smallEnd(idir);
+    const int hi = bx.bigEnd(idir);
+    const int di = (idir == 0), dj = (idir == 1), dk = (idir == 2);
+
+    AMREX_HOST_DEVICE_FOR_4D(cbx, q.ncomp, i, j, k, n,
+    {
+        const int c = (idir == 0) ? i : (idir == 1) ? j : k;
+
+        const Real sm2 = q(i-2*di,j-2*dj,k-2*dk,n);
+        const Real sm1 = q(i-  di,j-  dj,k-  dk,n);
+        const Real s0  = q(i     ,j     ,k     ,n);
+        const Real sp1 = q(i+  di,j+  dj,k+  dk,n);
+        const Real sp2 = q(i+2*di,j+2*dj,k+2*dk,n);
+        const Real fl  = flatn(i,j,k);
+
+        Real sm, sp;
+
+        if (ppm == 0)
+        {
+            const Real dq = fl*plm_slope(sm2, sm1, s0, sp1, sp2);
+            sm = s0 - 0.5*dq;
+            sp = s0 + 0.5*dq;
+        }
+        else
+        {
+            const Real dvm = vl_slope(sm2, sm1, s0);
+            const Real dv0 = vl_slope(sm1, s0, sp1);
+            const Real dvp = vl_slope(s0, sp1, sp2);
+
+            // Edge values between neighbouring cell averages
+            sm = 0.5*(s0 + sm1) - (1.0/6.0)*(dv0 - dvm);
+            sm = amrex::max(sm, amrex::min(s0, sm1));
+            sm = amrex::min(sm, amrex::max(s0, sm1));
+
+            sp = 0.5*(sp1 + s0) - (1.0/6.0)*(dvp - dv0);
+            sp = amrex::max(sp, amrex::min(sp1, s0));
+            sp = amrex::min(sp, amrex::max(sp1, s0));
+
+            sm = fl*sm + (1.0 - fl)*s0;
+            sp = fl*sp + (1.0 - fl)*s0;
+
+            // Colella and Sekora (2008) limiter, as in ca_ppm_reconstruct
+            if ((sp - s0)*(s0 - sm) <= 0.0) {
+                sp = s0;
+                sm = s0;
+            } else if (std::abs(sp - s0) >= 2.0*std::abs(sm - s0)) {
+                sp = 3.0*s0 - 2.0*sm;
+            } else if (std::abs(sm - s0) >= 2.0*std::abs(sp - s0)) {
+                sm = 3.0*s0 - 2.0*sp;
+            }
+        }
+
+        if (c >= lo) qp(i,j,k,n) = sm;
+        if (c <= hi) qm(i+di,j+dj,k+dk,n) = sp;
+    });
+}
+
+void
+Nyx::construct_mol_hydro_source (Real time, Real dt, Real a_old, Real a_new,
+                                 MultiFab& Sborder, MultiFab& D_border,
+                                 MultiFab& ext_src_old, MultiFab& hydro_source,
+                                 MultiFab& grav_vector,
+                                 bool init_flux_register, bool add_to_flux_register)
+{
+    BL_PROFILE("Nyx::construct_mol_hydro_source()");
+
+    Gpu::LaunchSafeGuard lsg(true);
+    MultiFab::RegionTag amrhydro_tag("HydroConstruct_" + std::to_string(level));
+    const Real strt_time = ParallelDescriptor::second();
+
+    if (verbose && ParallelDescriptor::IOProcessor())
+        std::cout << "... Entering construct_mol_hydro_source" << std::endl << std::endl;
+
+    // The stages do not overlap the ghost-cell exchange
+    hydro_fill_finish(Sborder, D_border);
+
+    BoundaryFluxes fluxes;
+    const int finest_level = parent->finestLevel();
+
+    FluxRegister* fine    = 0;
+    FluxRegister* current = 0;
+
+    if (finest_level != 0 && do_reflux)
+    {
+        if (level < finest_level)
+        {
+            fine = &get_flux_reg(level+1);
+            if (init_flux_register)
+                fine->setVal(0);
+        }
+        if (level > 0)
+            current = &get_flux_reg(level);
+
+        if (add_to_flux_register)
+            fluxes.define(grids, dmap, NUM_STATE, current != 0,
+                          fine ? &parent->boxArray(level+1) : nullptr,
+                          fine ? parent->refRatio(level) : IntVect::TheUnitVector());
+    }
+
+    BoundaryFluxes* keep_fluxes = (finest_level != 0 && do_reflux && add_to_flux_register)
+                                ? &fluxes : nullptr;
+
+    if (riemann_batched)
+        riemann_rows_init();
+    if (hydro_specialize)
+        hydro_kernels_init();
+
+    // Stage 1: L(U^n)
+    mol_hydro_stage(0, dt, a_old, a_new, Sborder, hydro_source, keep_fluxes);
+
+    // U* with ghost cells. The ghost cells come from the new-time state data,
+    // so U* is put there for the fill; if that is also Sborder, it is put
+    // back afterwards.
+    MultiFab& S_new = get_new_data(State_Type);
+    MultiFab S_star(grids, dmap, NUM_STATE, NUM_GROW);
+    {
+        // The density floor in the update looks at neighbouring cells
+        MultiFab::Copy(S_star, Sborder, 0, 0, NUM_STATE, NUM_GROW);
+        MultiFab divu_cc(grids, dmap, 1, 0);
+        divu_cc.setVal(0.);
+        update_state_with_sources(Sborder, S_star,
+                                  ext_src_old, hydro_source, grav_vector, divu_cc,
+                                  dt, a_old, a_new);
+    }
+
+    std::unique_ptr<MultiFab> S_keep;
+    if (&S_new == &Sborder)
+    {
+        S_keep.reset(new MultiFab(S_new.boxArray(), S_new.DistributionMap(),
+                                  S_new.nComp(), S_new.nGrow()));
+        MultiFab::Copy(*S_keep, S_new, 0, 0, S_new.nComp(), S_new.nGrow());
+    }
+
+    MultiFab::Copy(S_new, S_star, 0, 0, NUM_STATE, 0);
+    FillPatch(*this, S_star, NUM_GROW, state[State_Type].curTime(), State_Type, 0, NUM_STATE);
+
+    if (S_keep)
+        MultiFab::Copy(S_new, *S_keep, 0, 0, S_new.nComp(), S_new.nGrow());
+
+    // Stage 2: L(U*), averaged with stage 1
+    {
+        MultiFab hydro_source_star(grids, dmap, NUM_STATE, 0);
+        mol_hydro_stage(1, dt, a_old, a_new, S_star, hydro_source_star, keep_fluxes);
+        MultiFab::LinComb(hydro_source, 0.5, hydro_source, 0, 0.5, hydro_source_star, 0,
+                          0, NUM_STATE, 0);
+    }
+
+    if (verbose > 0)
+    {
+        const int IOProc   = ParallelDescriptor::IOProcessorNumber();
+        Real      run_time = ParallelDescriptor::second() - strt_time;
+
+        ParallelDescriptor::ReduceRealMax(run_time,IOProc);
+
+        if (ParallelDescriptor::IOProcessor())
+            std::cout << "Nyx::construct_mol_hydro_source() time = " << run_time << "\n" << "\n";
+    }
+
+    if (keep_fluxes)
+        fluxes.add_to_registers(current, fine);
+}
+
+void
+Nyx::mol_hydro_stage (int stage, Real dt, Real a_old, Real a_new,
+                      MultiFab& Sborder, MultiFab& hydro_source,
+                      BoundaryFluxes* fluxes)
+{
+    BL_PROFILE("Nyx::mol_hydro_stage()");
+
+    amrex::GpuArray<Real,3> dx = geom.CellSizeArray();
+    amrex::GpuArray<Real,3> area{AMREX_D_DECL(dx[1] * dx[2],
+                                              dx[0] * dx[2],
+                                              dx[0] * dx[1])};
+
+    const int* domain_lo = geom.Domain().loVect();
+    const int* domain_hi = geom.Domain().hiVect();
+
+    const int ppm = ppm_type;
+
+    // Quiescent tiles (nyx.hydro_skip_tol)
+    iMultiFab skip_mask;
+    if (hydro_skip_tol > 0)
+        hydro_quiescent_mask(Sborder, skip_mask, fluxes);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    {
+    HydroScratch& scratch = HydroScratch::get();
+
+    FArrayBox q, qaux, flatn, shk, div;
+    FArrayBox qm, qp, q_int;
+    FArrayBox pdivu;
+    FArrayBox flux[AMREX_SPACEDIM];
+    FArrayBox qe[AMREX_SPACEDIM];
+
+    for (MFIter mfi(hydro_source, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        scratch.reset();
+        HydroStageTimer stage_timer;
+
+        const Box& bx  = mfi.tilebox();
+
+        // Quiescent floor-density tiles (nyx.hydro_skip_tol)
+        if (hydro_skip_tol > 0 && hydro_tile_skip(mfi, skip_mask))
+        {
+            stage_timer.mark(HydroStageTimers::Consup);
+            hydro_quiescent_source(bx, Sborder[mfi], hydro_source[mfi],
+                                   dx.data(), dt, a_old, a_new);
+            continue;
+        }
+
+        const Box& obx = amrex::grow(bx, 1);
+        const Box& qbx = amrex::grow(bx, NUM_GROW);
+
+        const auto fab_Sborder = Sborder.array(mfi);
+        const auto fab_hydro_source = hydro_source.array(mfi);
+
+        scratch.alloc(q, qbx, QVAR);
+        scratch.alloc(qaux, qbx, 1);
+        const auto fab_q = q.array();
+        const auto fab_qaux = qaux.array();
+
+        stage_timer.mark(HydroStageTimers::Ctoprim);
+        AMREX_LAUNCH_DEVICE_LAMBDA(qbx, tqbx,
+        {
+            ca_ctoprim(AMREX_INT_ANYD(tqbx.loVect()), AMREX_INT_ANYD(tqbx.hiVect()),
+                       BL_ARR4_TO_FORTRAN_3D(fab_Sborder),
+                       BL_ARR4_TO_FORTRAN_3D(fab_q),
+                       BL_ARR4_TO_FORTRAN_3D(fab_qaux));
+        });
+
+        scratch.alloc(flatn, obx, 1);
+        const auto fab_flatn = flatn.array();
+        stage_timer.mark(HydroStageTimers::Flatten);
+        if (use_flattening == 1) {
+            const int pres_comp = QPRES;
+            AMREX_LAUNCH_DEVICE_LAMBDA(obx, tobx,
+            {
+                ca_uflatten(AMREX_INT_ANYD(tobx.loVect()), AMREX_INT_ANYD(tobx.hiVect()),
+                            BL_ARR4_TO_FORTRAN_3D(fab_q),
+                            BL_ARR4_TO_FORTRAN_3D(fab_flatn),
+                            pres_comp);
+            });
+        } else {
+            AMREX_PARALLEL_FOR_3D(obx, i, j, k, { fab_flatn(i,j,k) = 1.0; });
+        }
+
+        // divu for the artificial viscosity
+        scratch.alloc(div, obx, 1);
+        const auto fab_div = div.array();
+        stage_timer.mark(HydroStageTimers::Consup);
+        AMREX_LAUNCH_DEVICE_LAMBDA(obx, tobx,
+        {
+            divu(AMREX_INT_ANYD(tobx.loVect()), AMREX_INT_ANYD(tobx.hiVect()),
+                 BL_ARR4_TO_FORTRAN_3D(fab_q),
+                 dx.data(),
+                 BL_ARR4_TO_FORTRAN_3D(fab_div));
+        });
+
+        // No shock flag without the CTU traces
+        scratch.alloc(shk, obx, 1);
+        const auto fab_shk = shk.array();
+        AMREX_PARALLEL_FOR_3D(obx, i, j, k, { fab_shk(i,j,k) = 0.0; });
+
+        scratch.alloc(qm, obx, QVAR);
+        scratch.alloc(qp, obx, QVAR);
+        scratch.alloc(q_int, obx, QVAR);
+        const auto fab_qm = qm.array();
+        const auto fab_qp = qp.array();
+        const auto fab_q_int = q_int.array();
+
+        for (int idir = 0; idir < AMREX_SPACEDIM; ++idir)
+        {
+            const Box& nbx = amrex::surroundingNodes(bx, idir);
+            const int idir_f = idir + 1;
+
+            scratch.alloc(flux[idir], nbx, NUM_STATE);
+            scratch.alloc(qe[idir], nbx, NGDNV);
+            const auto fab_flux = flux[idir].array();
+            const auto fab_qe = qe[idir].array();
+
+            stage_timer.mark(HydroStageTimers::Trace);
+            mol_reconstruct(bx, idir, ppm, q.const_array(), flatn.const_array(), fab_qm, fab_qp);
+
+            stage_timer.mark(HydroStageTimers::Riemann);
+            if (riemann_batched) {
+                cmpflx_rows(nbx, idir_f, qm.const_array(), qp.const_array(), qaux.const_array(),
+                            fab_flux, fab_qe);
+            } else {
+            AMREX_LAUNCH_DEVICE_LAMBDA(nbx, tnbx,
+            {
+                cmpflx_plus_godunov(AMREX_INT_ANYD(tnbx.loVect()), AMREX_INT_ANYD(tnbx.hiVect()),
+                                    BL_ARR4_TO_FORTRAN_3D(fab_qm),
+                                    BL_ARR4_TO_FORTRAN_3D(fab_qp), 1, 1,
+                                    BL_ARR4_TO_FORTRAN_3D(fab_flux),
+                                    BL_ARR4_TO_FORTRAN_3D(fab_q_int),
+                                    BL_ARR4_TO_FORTRAN_3D(fab_qe),
+                                    BL_ARR4_TO_FORTRAN_3D(fab_qaux),
+                                    BL_ARR4_TO_FORTRAN_3D(fab_shk),
+                                    idir_f, AMREX_INT_ANYD(domain_lo), AMREX_INT_ANYD(domain_hi));
+            });
+            }
+
+            // clean the fluxes
+            stage_timer.mark(HydroStageTimers::Consup);
+            AMREX_LAUNCH_DEVICE_LAMBDA(nbx, tnbx,
+            {
+                apply_av(AMREX_INT_ANYD(tnbx.loVect()), AMREX_INT_ANYD(tnbx.hiVect()),
+                         BL_ARR4_TO_FORTRAN_3D(fab_div),
+                         BL_ARR4_TO_FORTRAN_3D(fab_Sborder),
+                         BL_ARR4_TO_FORTRAN_3D(fab_flux),
+                         idir_f, dx.data(), dt);
+            });
+
+            AMREX_LAUNCH_DEVICE_LAMBDA(nbx, tnbx,
+            {
+                normalize_species_fluxes(AMREX_INT_ANYD(tnbx.loVect()), AMREX_INT_ANYD(tnbx.hiVect()),
+                                         BL_ARR4_TO_FORTRAN_3D(fab_flux));
+            });
+        }
+
+        scratch.release(q_int);
+        scratch.release(qp);
+        scratch.release(qm);
+        scratch.release(shk);
+        scratch.release(div);
+        scratch.release(flatn);
+        scratch.release(qaux);
+        scratch.release(q);
+
+        // Faces next to skipped tiles take the flux those tiles use
+        if (hydro_skip_tol > 0)
+            hydro_skip_face_fluxes(bx, Sborder[mfi], skip_mask[mfi], flux, qe, dx.data(), dt);
+
+        scratch.alloc(pdivu, bx, 1);
+        const auto fab_pdivu = pdivu.array();
+
+        GpuArray<Array4<Real>, AMREX_SPACEDIM> fab_flux{
+            AMREX_D_DECL(flux[0].array(), flux[1].array(), flux[2].array())};
+        GpuArray<Array4<Real>, AMREX_SPACEDIM> fab_qe{
+            AMREX_D_DECL(qe[0].array(), qe[1].array(), qe[2].array())};
+
+        if (hydro_specialize)
+            consup_spec(bx, fab_Sborder, fab_hydro_source, fab_flux, fab_qe,
+                        dx.data(), dt, a_old, a_new);
+        else
+        AMREX_LAUNCH_DEVICE_LAMBDA(bx, tbx,
+        {
+            ca_consup(AMREX_INT_ANYD(tbx.loVect()), AMREX_INT_ANYD(tbx.hiVect()),
+                      BL_ARR4_TO_FORTRAN(fab_Sborder),
+                      BL_ARR4_TO_FORTRAN(fab_hydro_source),
+                      BL_ARR4_TO_FORTRAN(fab_flux[0]),
+                      BL_ARR4_TO_FORTRAN(fab_flux[1]),
+                      BL_ARR4_TO_FORTRAN(fab_flux[2]),
+                      BL_ARR4_TO_FORTRAN_3D(fab_qe[0]),
+                      BL_ARR4_TO_FORTRAN_3D(fab_qe[1]),
+                      BL_ARR4_TO_FORTRAN_3D(fab_qe[2]),
+                      BL_ARR4_TO_FORTRAN_3D(fab_pdivu),
+                      dx.data(),dt,a_old,a_new);
+        });
+
+        if (fluxes)
+        {
+            for (int idir = 0; idir < AMREX_SPACEDIM; ++idir)
+            {
+                const Box& nbx = amrex::surroundingNodes(bx, idir);
+                const auto fab_flux_d = flux[idir].array();
+
+                AMREX_LAUNCH_DEVICE_LAMBDA(nbx, tnbx,
+                {
+                    scale_flux(AMREX_INT_ANYD(tnbx.loVect()), AMREX_INT_ANYD(tnbx.hiVect()),
+                               BL_ARR4_TO_FORTRAN_3D(fab_flux_d),
+                               area[idir], dt, a_old, a_new);
+                });
+
+                fluxes->store(mfi, idir, flux[idir], 0.5, stage == 1);
+            }
+        }
+
+        Gpu::streamSynchronize();
+    } // MFIter loop
+
+    // Views into the arena do not outlive the loop
+    scratch.reset();
+
+    } // OMP region
+
+    if (hydro_skip_tol > 0 && hydro_skip_check)
+        hydro_skip_conservation_check(Sborder, hydro_source, dt, a_old, a_new);
+}
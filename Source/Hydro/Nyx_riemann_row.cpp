@@ -0,0 +1,109 @@
+#include "Nyx.H"
+#include "Nyx_F.H"
+#include "Nyx_riemann_row.H"
+
+using namespace amrex;
+
+namespace
+{
+    constexpr int max_pass = 32;
+
+    RiemannParams riemann_params;
+    int qpass[max_pass];
+    int upass[max_pass];
+}
+
+void
+Nyx::riemann_rows_init ()
+{
+    int solver, hybrid, analriem, csmall_gamma, gamma_minus, npass;
+
+    fort_get_riemann_params(&riemann_params.gamma,
+                            &riemann_params.small_dens, &riemann_params.small_pres,
+                            &solver, &hybrid, &analriem, &csmall_gamma, &gamma_minus,
+                            &max_pass, &npass, qpass, upass);
+
+    if (solver != 0 || hybrid != 0)
+        amrex::Abort("Nyx::riemann_batched only implements riemann_solver = 0 without hybrid_riemann");
+    if (npass > max_pass)
+        amrex::Abort("Nyx::riemann_batched: too many passively advected quantities");
+
+    riemann_params.npass = npass;
+    riemann_params.opts  = RiemannOpt::GammaLaw
+                         | (analriem     ? RiemannOpt::AnalRiem    : 0)
+                         | (csmall_gamma ? RiemannOpt::CsmallGamma : 0)
+                         | (gamma_minus  ? RiemannOpt::GammaMinus  : 0);
+}
+
+//
+// Same results as cmpflx_plus_godunov with riemann_solver = 0 on the faces of
+// bx normal to idir (1, 2 or 3), one x row at a time. Every component of an
+// Array4 is contiguous in x, so the rows are handed to the kernel in place.
+// Unlike the Fortran path, the full interface state (q_int) is not written.
+//
+void
+Nyx::cmpflx_rows (const Box& bx, int idir,
+                  Array4<Real const> const& qm, Array4<Real const> const& qp,
+                  Array4<Real const> const& qaux,
+                  Array4<Real> const& flx, Array4<Real> const& qg)
+{
+    BL_PROFILE("Nyx::cmpflx_rows()");
+
+    const RiemannParams& rp = riemann_params;
+
+    // Normal and transverse velocity components, as in riemannus
+    const int d   = idir - 1;
+    const int iu  = 1 + d;
+    const int iv1 = (d == 0) ? 2 : 1;
+    const int iv2 = (d == 2) ? 2 : 3;
+
+    const IntVect sh = IntVect::TheDimensionVector(d);
+    const bool have_game = qg.ncomp > 5;
+
+    const auto lo = amrex::lbound(bx);
+    const auto hi = amrex::ubound(bx);
+    const int  n  = hi.x - lo.x + 1;
+
+    const Real* lpass[max_pass];
+    const Real* rpass[max_pass];
+    Real*       fpass[max_pass];
+
+    for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+
+            for (int m = 0; m < rp.npass; ++m) {
+                lpass[m] = &qm (lo.x,j,k,qpass[m]);
+                rpass[m] = &qp (lo.x,j,k,qpass[m]);
+                fpass[m] = &flx(lo.x,j,k,upass[m]);
+            }
+
+            const RiemannRowIn L {&qm(lo.x,j,k,0),   &qm(lo.x,j,k,iu),
+                                  &qm(lo.x,j,k,iv1), &qm(lo.x,j,k,iv2),
+                                  &qm(lo.x,j,k,4),   &qm(lo.x,j,k,5),
+                                  &qaux(lo.x-sh[0],j-sh[1],k-sh[2],0), nullptr,
+                                  lpass};
+
+            const RiemannRowIn R {&qp(lo.x,j,k,0),   &qp(lo.x,j,k,iu),
+                                  &qp(lo.x,j,k,iv1), &qp(lo.x,j,k,iv2),
+                                  &qp(lo.x,j,k,4),   &qp(lo.x,j,k,5),
+                                  &qaux(lo.x,j,k,0), nullptr,
+                                  rpass};
+
+            const RiemannRowOut F {&flx(lo.x,j,k,Density),
+                                   &flx(lo.x,j,k,Xmom+d),
+                                   &flx(lo.x,j,k,Xmom+iv1-1),
+                                   &flx(lo.x,j,k,Xmom+iv2-1),
+                                   &flx(lo.x,j,k,Eden),
+                                   &flx(lo.x,j,k,Eint),
+                                   fpass,
+                                   &qg(lo.x,j,k,0),
+                                   &qg(lo.x,j,k,iu),
+                                   &qg(lo.x,j,k,iv1),
+                                   &qg(lo.x,j,k,iv2),
+                                   &qg(lo.x,j,k,4),
+                                   have_game ? &qg(lo.x,j,k,5) : nullptr};
+
+            riemann_cgf_row_dispatch(n, L, R, F, rp);
+        }
+    }
+}
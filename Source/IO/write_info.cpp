@@ -22,7 +22,12 @@ Nyx::write_info ()
         if (do_hydro)
         {
             // Removed reset internal energy before call to compute_temp, still compute new temp
-            compute_new_temp(S_new,D_new);
+            if (!diag_eos_current)
+            {
+                compute_new_temp(S_new,D_new,&hydro_cfl_dt);
+                diag_eos_current = true;
+                hydro_cfl_dt_current = true;
+            }
             max_t = D_new.norm0(Temp_comp);
             compute_rho_temp(rho_T_avg, T_avg, Tinv_avg, T_meanrho);
             compute_gas_fractions(1.0e5, 120.0, whim_mass_frac, whim_vol_frac,
@@ -289,6 +289,11 @@ Nyx::initData ()
     IR_new.setVal(0.0);
 #endif
 
+#ifdef HEATCOOL
+    // No work measured yet
+    get_new_data(Work_Estimate_Type).setVal(load_balance_cell_coeff);
+#endif
+
 #ifndef NO_HYDRO
     //
     // Read in initial conditions from a file.
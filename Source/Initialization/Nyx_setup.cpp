@@ -8,6 +8,9 @@
 #ifdef FORCING
 #include "Forcing.H"
 #endif
+#ifdef HEATCOOL
+#include "AtomicRatesCache.H"
+#endif
 
 using namespace amrex;
 using std::string;
@@ -209,6 +212,7 @@ Nyx::hydro_setup()
 #ifdef HEATCOOL
     fort_tabulate_rates();
     amrex::Gpu::streamSynchronize();
+    AtomicRatesCache::init();
 #endif
 
     if (use_const_species == 1)
@@ -259,6 +263,15 @@ Nyx::hydro_setup()
                            store_in_checkpoint);
 #endif
 
+#ifdef HEATCOOL
+    // The work per cell the mesh is balanced on (load_balance_wgt_strategy = 3)
+    store_in_checkpoint = false;
+    desc_lst.addDescriptor(Work_Estimate_Type, IndexType::TheCellType(),
+                           StateDescriptor::Point, 0, 1,
+                           &pc_interp, state_data_extrap,
+                           store_in_checkpoint);
+#endif
+
     Vector<BCRec> bcs(NUM_STATE);
     Vector<std::string> name(NUM_STATE);
 
@@ -374,6 +387,12 @@ Nyx::hydro_setup()
                           BndryFunc(generic_fill));
 #endif
 
+#ifdef HEATCOOL
+    set_scalar_bc(bc, phys_bc);
+    desc_lst.setComponent(Work_Estimate_Type, 0, "work_estimate", bc,
+                          BndryFunc(generic_fill));
+#endif
+
 #ifdef GRAVITY
     if (do_grav)
     {
@@ -672,6 +691,7 @@ Nyx::no_hydro_setup()
 
 #ifdef HEATCOOL
     fort_tabulate_rates();
+    AtomicRatesCache::init();
 #endif
 
     int coord_type = DefaultGeometry().Coord();
@@ -16,6 +16,9 @@ using std::string;
 #include <AMReX_CONSTANTS.H>
 #include <Nyx.H>
 #include <Nyx_F.H>
+#include <AtomicRatesCache.H>
+#include <HydroScratch.H>
+#include <HydroStageTimers.H>
 #include <Derive.H>
 #include <AMReX_VisMF.H>
 #include <AMReX_TagBox.H>
@@ -79,6 +82,10 @@ int Nyx::load_balance_int = -1;
 int Nyx::load_balance_wgt_strategy = 0;
 int Nyx::load_balance_wgt_nmax = -1;
 int Nyx::load_balance_strategy = DistributionMapping::SFC;
+Real Nyx::load_balance_cell_coeff     = 1.0;
+Real Nyx::load_balance_particle_coeff = 1.0;
+Real Nyx::load_balance_rhs_coeff      = 1.0;
+Real Nyx::load_balance_step_coeff     = 0.0;
 
 bool Nyx::dump_old = false;
 int Nyx::verbose      = 0;
@@ -147,6 +154,14 @@ int Nyx::use_sundials_constraint = 0;
 int Nyx::use_sundials_fused = 0;
 int Nyx::use_typical_steps = 0;
 int Nyx::sundials_alloc_type = 0;
+int Nyx::heat_cool_classify = 0;
+Real Nyx::heat_cool_explicit_tol = 0.05;
+int Nyx::heat_cool_lazy = 0;
+Real Nyx::heat_cool_lazy_tol = 1.0e-3;
+int Nyx::heat_cool_lazy_refresh = 8;
+Real Nyx::sundials_rtol = 1.0e-4;
+Real Nyx::sundials_atol = 1.0e-4;
+int Nyx::reuse_heat_cool_temp = 1;
 int Nyx::minimize_memory = 0;
 int Nyx::shrink_to_fit = 0;
 
@@ -202,6 +217,15 @@ int Nyx::ppm_reference      = 1;
 int Nyx::version_2          = 0;
 
 int Nyx::use_flattening     = 1;
+int Nyx::hydro_slab_planes  = 0;
+int Nyx::riemann_batched    = 0;
+int Nyx::hydro_specialize   = 0;
+int Nyx::hydro_overlap_fill = 0;
+int Nyx::hydro_mol          = 0;
+Real Nyx::hydro_skip_tol         = 0.0;
+Real Nyx::hydro_skip_dens_factor = 1.1;
+int Nyx::hydro_skip_check = 0;
+int Nyx::hydro_stage_timers = 0;
 int Nyx::ppm_flatten_before_integrals = 0;
 int Nyx::use_analriem       = 1;
 
@@ -265,6 +289,11 @@ Nyx::variable_cleanup ()
     }
 #endif
 
+#ifndef NO_HYDRO
+    clear_cvode_workspace_pool();
+    HydroScratch::clear_all();
+#endif
+
     desc_lst.clear();
 }
 
@@ -538,6 +567,14 @@ Nyx::read_params ()
     pp_nyx.query("minimize_memory", minimize_memory);
     pp_nyx.query("shrink_to_fit", shrink_to_fit);
     pp_nyx.query("use_typical_steps", use_typical_steps);
+    pp_nyx.query("heat_cool_classify", heat_cool_classify);
+    pp_nyx.query("heat_cool_explicit_tol", heat_cool_explicit_tol);
+    pp_nyx.query("heat_cool_lazy", heat_cool_lazy);
+    pp_nyx.query("heat_cool_lazy_tol", heat_cool_lazy_tol);
+    pp_nyx.query("heat_cool_lazy_refresh", heat_cool_lazy_refresh);
+    pp_nyx.query("sundials_rtol", sundials_rtol);
+    pp_nyx.query("sundials_atol", sundials_atol);
+    pp_nyx.query("reuse_heat_cool_temp", reuse_heat_cool_temp);
     pp_nyx.query("allow_untagging", allow_untagging);
     pp_nyx.query("use_const_species", use_const_species);
     pp_nyx.query("normalize_species", normalize_species);
@@ -546,22 +583,88 @@ Nyx::read_params ()
     pp_nyx.query("ppm_flatten_before_integrals", ppm_flatten_before_integrals);
     pp_nyx.query("use_analriem", use_analriem);
     pp_nyx.query("use_flattening", use_flattening);
+    pp_nyx.query("hydro_slab_planes", hydro_slab_planes);
+    pp_nyx.query("riemann_batched", riemann_batched);
+    pp_nyx.query("hydro_specialize", hydro_specialize);
+    pp_nyx.query("hydro_overlap_fill", hydro_overlap_fill);
+    pp_nyx.query("hydro_mol", hydro_mol);
+    pp_nyx.query("hydro_skip_tol", hydro_skip_tol);
+    pp_nyx.query("hydro_skip_dens_factor", hydro_skip_dens_factor);
+    pp_nyx.query("hydro_skip_check", hydro_skip_check);
+    pp_nyx.query("hydro_stage_timers", hydro_stage_timers);
+#ifndef NO_HYDRO
+    HydroStageTimers::enable(hydro_stage_timers != 0);
+#endif
     pp_nyx.query("version_2", version_2);
 
     if(hydro_convert == 1)
       { 
         if (ppm_type == 0 && ParallelDescriptor::IOProcessor())
           std::cout << "Nyx::setting hydro_convert = 1 with ppm_type = 0 \n";
-        if(ppm_type != 0)
-          amrex::Error("Nyx::ppm_type must be 0 with hydro_convert = 1");
+        if(ppm_type != 0 && !(hydro_mol == 1 && ppm_type == 1))
+          amrex::Error("Nyx::ppm_type must be 0 with hydro_convert = 1 (or 0 or 1 with hydro_mol = 1)");
         //      if(use_analriem != 0)
         //amrex::Error("Nyx::use_analriem must be 0 with hydro_convert = 1");
       }
 
+    if(hydro_mol != 0 && hydro_convert != 1)
+      {
+          amrex::Error("Nyx::hydro_mol requires hydro_convert = 1");
+      }
+    if(hydro_mol != 0 && strang_fuse > 0)
+      {
+          amrex::Error("Nyx::hydro_mol is not implemented with strang_fuse > 0");
+      }
+    if(hydro_specialize != 0 && hydro_convert != 1)
+      {
+          amrex::Error("Nyx::hydro_specialize requires hydro_convert = 1");
+      }
+    if(hydro_skip_tol > 0 && hydro_convert != 1)
+      {
+          amrex::Error("Nyx::hydro_skip_tol > 0 requires hydro_convert = 1");
+      }
+    if(hydro_skip_tol > 0 && hydro_overlap_fill != 0)
+      {
+          amrex::Error("Nyx::hydro_skip_tol > 0 is not implemented with hydro_overlap_fill");
+      }
+
+#ifdef AMREX_USE_GPU
+    if(hydro_slab_planes > 0)
+      {
+          amrex::Error("Nyx::hydro_slab_planes is only supported in CPU builds");
+      }
+    if(riemann_batched != 0)
+      {
+          amrex::Error("Nyx::riemann_batched is only supported in CPU builds");
+      }
+    if(hydro_skip_tol > 0)
+      {
+          amrex::Error("Nyx::hydro_skip_tol > 0 is only supported in CPU builds");
+      }
+    if(hydro_specialize != 0)
+      {
+          amrex::Error("Nyx::hydro_specialize is only supported in CPU builds");
+      }
+#endif
+
     if(use_typical_steps != 0 && strang_grown_box == 0)
       { 
           amrex::Error("Nyx::use_typical_steps must be 0 with strang_grown_box = 0");
       }
+
+    if(heat_cool_classify != 0 && heat_cool_type != 11)
+      {
+          amrex::Error("Nyx::heat_cool_classify requires heat_cool_type = 11");
+      }
+
+    if(heat_cool_lazy != 0 && heat_cool_type != 11)
+      {
+          amrex::Error("Nyx::heat_cool_lazy requires heat_cool_type = 11");
+      }
+
+    // compute_new_temp clamps Temp at large_temp in this mode, the integrators do not
+    if (max_temp_dt == 1)
+        reuse_heat_cool_temp = 0;
    
     if (do_hydro == 1)
     {
@@ -632,6 +735,14 @@ Nyx::read_params ()
     pp_nyx.query("load_balance_wgt_strategy", load_balance_wgt_strategy);
     load_balance_wgt_nmax = amrex::ParallelDescriptor::NProcs();
     pp_nyx.query("load_balance_wgt_nmax",     load_balance_wgt_nmax);
+    pp_nyx.query("load_balance_cell_coeff",     load_balance_cell_coeff);
+    pp_nyx.query("load_balance_particle_coeff", load_balance_particle_coeff);
+    pp_nyx.query("load_balance_rhs_coeff",      load_balance_rhs_coeff);
+    pp_nyx.query("load_balance_step_coeff",     load_balance_step_coeff);
+#ifndef HEATCOOL
+    if (load_balance_wgt_strategy == 3)
+        amrex::Error("Nyx::load_balance_wgt_strategy = 3 needs a HEATCOOL build");
+#endif
 
     std::string theStrategy;
 
@@ -677,6 +788,9 @@ Nyx::Nyx ()
     {
         flux_reg = 0;
     }
+    diag_eos_current = false;
+    hydro_fill_pending = false;
+    hydro_cfl_dt_current = false;
 #endif
     fine_mask = 0;
 }
@@ -704,6 +818,9 @@ Nyx::Nyx (Amr&            papa,
         if (level > 0 && do_reflux)
             flux_reg = new FluxRegister(grids, dmap, crse_ratio, level, NUM_STATE);
     }
+    diag_eos_current = false;
+    hydro_fill_pending = false;
+    hydro_cfl_dt_current = false;
 #endif
 
 #ifdef GRAVITY
@@ -754,7 +871,7 @@ Nyx::Nyx (Amr&            papa,
 #ifdef HEATCOOL
      // Initialize "this_z" in the atomic_rates_module
     if (heat_cool_type == 3 || heat_cool_type == 4 || heat_cool_type == 5 || heat_cool_type == 7 || heat_cool_type == 9 || heat_cool_type == 10 || heat_cool_type == 11 || heat_cool_type == 12)
-         fort_interp_to_this_z(&initial_z);
+         AtomicRatesCache::interp_to_z(initial_z);
 #endif
 }
 
@@ -891,6 +1008,11 @@ Nyx::init (AmrLevel& old)
     FillPatch(old, IR_new, 0, cur_time, SDC_IR_Type, 0, 1);
 #endif
 
+#ifdef HEATCOOL
+    MultiFab& W_new = get_new_data(Work_Estimate_Type);
+    FillPatch(old, W_new, 0, cur_time, Work_Estimate_Type, 0, 1);
+#endif
+
     amrex::Gpu::Device::streamSynchronize();
 
 }
@@ -950,6 +1072,11 @@ Nyx::init ()
     FillCoarsePatch(Phi_new, 0, cur_time, PhiGrav_Type, 0, Phi_new.nComp());
 #endif
 
+#ifdef HEATCOOL
+    MultiFab& W_new = get_new_data(Work_Estimate_Type);
+    FillCoarsePatch(W_new, 0, cur_time, Work_Estimate_Type, 0, 1);
+#endif
+
     // We set dt to be large for this new level to avoid screwing up
     // computeNewDt.
     parent->setDtLevel(1.e100, level);
@@ -1007,6 +1134,14 @@ Nyx::est_time_step (Real dt_old)
         Real a = get_comoving_a(cur_time);
         const auto dx = geom.CellSizeArray();
 
+        if (diag_eos_current && hydro_cfl_dt_current)
+        {
+          // The state has not changed since the compute_new_temp or heat/cool
+          // pass that found this minimum
+          est_dt = std::min(est_dt, hydro_cfl_dt);
+        }
+        else
+        {
 #ifdef _OPENMP
 #pragma omp parallel reduction(min:est_dt)
 #endif
@@ -1033,34 +1168,9 @@ Nyx::est_time_step (Real dt_old)
                                               for         (int k = lo.z; k <= hi.z; ++k) {
                                                 for     (int j = lo.y; j <= hi.y; ++j) {
                                                   for (int i = lo.x; i <= hi.x; ++i) {
-                                                    if(u(i,j,k,Density)<=1.1*dummy_small_dens && dummy_max_temp_dt==1)
-                                                      continue;
-
-                                                    Real rhoInv = 1.0 / u(i,j,k,Density);
-                                                    Real ux     = u(i,j,k,Xmom)*rhoInv;
-                                                    Real uy     = u(i,j,k,Ymom)*rhoInv;
-                                                    Real uz     = u(i,j,k,Zmom)*rhoInv;
-
-                                                    // Use internal energy for calculating dt 
-                                                    Real e  = u(i,j,k,Eint)*rhoInv;
-
-                                                    Real c;
-                                                    // Protect against negative e
-#ifdef HEATCOOL
-                                                    if (e > 0.0)
-                                                      c=sound_speed_factor*std::sqrt(e);
-#else
-                                                    if (e > 0.0)
-                                                      c=sound_speed_factor*std::sqrt(u(i,j,k,Density)*e/u(i,j,k,Density));
-#endif
-                                                    else
-                                                      c = 0.0;
-
-                                                    Real dt1 = dx[0]/(c + std::abs(ux));
-                                                    Real dt2 = dx[1]/(c + std::abs(uy));
-                                                    Real dt3 = dx[2]/(c + std::abs(uz));
-                                                    dt_gpu = amrex::min(dt_gpu,amrex::min(dt1,amrex::min(dt2,dt3)));
-
+                                                    dt_gpu = amrex::min(dt_gpu,
+                                                                        hydro_cell_dt(i, j, k, u, dx, sound_speed_factor,
+                                                                                      dummy_small_dens, dummy_max_temp_dt));
                                                   }
                                                 }
                                               }
@@ -1070,6 +1180,7 @@ Nyx::est_time_step (Real dt_old)
           est_dt = std::min(est_dt, dt);
 
         }
+        }
 
         // If in comoving coordinates, then scale dt (based on u and c) by a
         est_dt *= a;
@@ -1585,6 +1696,7 @@ Nyx::post_timestep (int iteration)
             {
                 Real dt_lev = parent->dtLevel(lev);
                 MultiFab&  S_new_lev = get_level(lev).get_new_data(State_Type);
+                get_level(lev).diag_eos_current = false;
                 Real cur_time = state[State_Type].curTime();
                 Real a_new = get_comoving_a(cur_time);
 
@@ -1705,11 +1817,17 @@ Nyx::post_timestep (int iteration)
        MultiFab& S_new = get_new_data(State_Type);
        MultiFab& D_new = get_new_data(DiagEOS_Type);
 
-       // First reset internal energy before call to compute_temp
-       reset_internal_energy_nostore(S_new,D_new);
-
-       // Re-compute temperature after all the other updates.
-       compute_new_temp(S_new,D_new);
+       if (!diag_eos_current)
+       {
+           // First reset internal energy before call to compute_temp
+           reset_internal_energy_nostore(S_new,D_new);
+
+           // Re-compute temperature after all the other updates, and the
+           // hydro dt limit for est_time_step with it
+           compute_new_temp(S_new,D_new,&hydro_cfl_dt);
+           diag_eos_current = true;
+           hydro_cfl_dt_current = true;
+       }
     }
 #endif
 
@@ -1765,6 +1883,11 @@ Nyx::post_restart ()
 
     if (inhomo_reion) init_zhi();
 
+#ifdef HEATCOOL
+    // Not in the checkpoint
+    get_new_data(Work_Estimate_Type).setVal(load_balance_cell_coeff);
+#endif
+
 #ifdef NO_HYDRO
     Real cur_time = state[PhiGrav_Type].curTime();
 #else
@@ -1878,6 +2001,70 @@ Nyx::set_small_values ()
 }
 #endif
 
+void
+Nyx::set_heat_cool_integrator (int type, Real rtol, Real atol)
+{
+    heat_cool_type = type;
+    sundials_rtol  = rtol;
+    sundials_atol  = atol;
+    fort_set_heat_cool_type(type);
+}
+
+MultiFab&
+Nyx::get_heat_cool_cost ()
+{
+    if (!heat_cool_cost || heat_cool_cost->boxArray() != grids
+                        || heat_cool_cost->DistributionMap() != dmap)
+    {
+        heat_cool_cost.reset(new MultiFab(grids, dmap, 2, 0));
+        heat_cool_cost->setVal(0.0);
+    }
+    return *heat_cool_cost;
+}
+
+MultiFab&
+Nyx::get_heat_cool_lazy_state ()
+{
+    if (!heat_cool_lazy_state || heat_cool_lazy_state->boxArray() != grids
+                              || heat_cool_lazy_state->DistributionMap() != dmap)
+    {
+        // Start every cell due for a full integration
+        heat_cool_lazy_state.reset(new MultiFab(grids, dmap, 4, 0));
+        heat_cool_lazy_state->setVal(0.0);
+        heat_cool_lazy_state->setVal(heat_cool_lazy_refresh, 1, 1);
+    }
+    return *heat_cool_lazy_state;
+}
+
+#ifdef HEATCOOL
+void
+Nyx::set_work_estimate ()
+{
+    BL_PROFILE("Nyx::set_work_estimate()");
+
+    MultiFab& work = get_new_data(Work_Estimate_Type);
+    MultiFab& cost = get_heat_cool_cost();
+
+    work.setVal(load_balance_cell_coeff);
+    MultiFab::Saxpy(work, load_balance_rhs_coeff,  cost, 0, 0, 1, 0);
+    MultiFab::Saxpy(work, load_balance_step_coeff, cost, 1, 0, 1, 0);
+
+    if (load_balance_particle_coeff != 0 && theDMPC())
+    {
+        MultiFab particle_mf(grids, theDMPC()->ParticleDistributionMap(level), 1, 1);
+        particle_mf.setVal(0.0);
+        theDMPC()->Increment(particle_mf, level);
+
+        MultiFab npart(grids, dmap, 1, 0);
+        npart.copy(particle_mf, 0, 0, 1);
+        MultiFab::Saxpy(work, load_balance_particle_coeff, npart, 0, 0, 1, 0);
+    }
+
+    // Start measuring work afresh
+    cost.setVal(0.0);
+}
+#endif
+
 void
 Nyx::postCoarseTimeStep (Real cumtime)
 {
@@ -1896,56 +2083,59 @@ Nyx::postCoarseTimeStep (Real cumtime)
 
     for (int lev = 0; lev <= parent->finestLevel(); lev++)
     {
-    
-        Vector<long> wgts(grids.size());
+        const BoxArray& ba = parent->boxArray(lev);
+        Vector<long> wgts(ba.size());
         DistributionMapping dm;
 
-        //Should these weights be constructed based on level=0, or lev from for?
         if(load_balance_wgt_strategy == 0)
         {
             for (unsigned int i = 0; i < wgts.size(); i++)
             {
-                wgts[i] = grids[i].numPts();
+                wgts[i] = ba[i].numPts();
             }
-            if(load_balance_strategy==DistributionMapping::Strategy::KNAPSACK)
-                dm.KnapSackProcessorMap(wgts, load_balance_wgt_nmax);
-            else if(load_balance_strategy==DistributionMapping::Strategy::SFC)
-                dm.SFCProcessorMap(grids, wgts, load_balance_wgt_nmax);
-            else if(load_balance_strategy==DistributionMapping::Strategy::ROUNDROBIN)
-                dm.RoundRobinProcessorMap(wgts, load_balance_wgt_nmax);
         }
         else if(load_balance_wgt_strategy == 1)
         {
-            wgts = theDMPC()->NumberOfParticlesInGrid(level,false,false);
-            if(load_balance_strategy==DistributionMapping::Strategy::KNAPSACK)
-                dm.KnapSackProcessorMap(wgts, load_balance_wgt_nmax);
-            else if(load_balance_strategy==DistributionMapping::Strategy::SFC)
-                dm.SFCProcessorMap(grids, wgts, load_balance_wgt_nmax);
-            else if(load_balance_strategy==DistributionMapping::Strategy::ROUNDROBIN)
-                dm.RoundRobinProcessorMap(wgts, load_balance_wgt_nmax);
+            wgts = theDMPC()->NumberOfParticlesInGrid(lev,false,false);
         }
         else if(load_balance_wgt_strategy == 2)
         {
-            MultiFab particle_mf(grids,theDMPC()->ParticleDistributionMap(level),1,1);
-            theDMPC()->Increment(particle_mf, level);
-            if(load_balance_strategy==DistributionMapping::Strategy::KNAPSACK)
-                dm.KnapSackProcessorMap(wgts, load_balance_wgt_nmax);
-            else if(load_balance_strategy==DistributionMapping::Strategy::SFC)
-                dm.SFCProcessorMap(grids, wgts, load_balance_wgt_nmax);
-            else if(load_balance_strategy==DistributionMapping::Strategy::ROUNDROBIN)
-                dm.RoundRobinProcessorMap(wgts, load_balance_wgt_nmax);
+            MultiFab particle_mf(ba,theDMPC()->ParticleDistributionMap(lev),1,1);
+            particle_mf.setVal(0.0);
+            theDMPC()->Increment(particle_mf, lev);
+
+            Vector<Real> box_wgts(ba.size(), 0.0);
+            for (MFIter mfi(particle_mf); mfi.isValid(); ++mfi)
+                box_wgts[mfi.index()] = particle_mf[mfi].sum<RunOn::Device>(mfi.validbox(),0);
+            ParallelDescriptor::ReduceRealSum(box_wgts.dataPtr(), box_wgts.size());
+
+            for (unsigned int i = 0; i < wgts.size(); i++)
+                wgts[i] = static_cast<long>(box_wgts[i]);
         }
-        else
+        else if(load_balance_wgt_strategy != 3)
         {
             amrex::Abort("Selected load balancing strategy not implemented");
         }
 
+        if(load_balance_wgt_strategy == 3)
+        {
+            // The mesh is balanced by Amr on the measured work (WorkEstType);
+            // the particles go with the cells they deposit into
+            dm = parent->DistributionMap(lev);
+        }
+        else if(load_balance_strategy==DistributionMapping::Strategy::KNAPSACK)
+            dm.KnapSackProcessorMap(wgts, load_balance_wgt_nmax);
+        else if(load_balance_strategy==DistributionMapping::Strategy::SFC)
+            dm.SFCProcessorMap(ba, wgts, load_balance_wgt_nmax);
+        else if(load_balance_strategy==DistributionMapping::Strategy::ROUNDROBIN)
+            dm.RoundRobinProcessorMap(wgts, load_balance_wgt_nmax);
+
         amrex::Gpu::Device::streamSynchronize();
         const DistributionMapping& newdmap = dm;
         
         for (int i = 0; i < theActiveParticles().size(); i++)
         {
-             theActiveParticles()[i]->Regrid(newdmap, grids, lev);
+             theActiveParticles()[i]->Regrid(newdmap, ba, lev);
 
              if(shrink_to_fit)
                  theActiveParticles()[i]->ShrinkToFit();
@@ -1953,8 +2143,16 @@ Nyx::postCoarseTimeStep (Real cumtime)
 
     amrex::Gpu::streamSynchronize();
     }
+    }
 
+#ifdef HEATCOOL
+    // The work of this coarse step, for the next mesh load balance by Amr
+    if (load_balance_wgt_strategy == 3)
+    {
+        for (int lev = 0; lev <= parent->finestLevel(); lev++)
+            get_level(lev).set_work_estimate();
     }
+#endif
 
    AmrLevel::postCoarseTimeStep(cumtime);
 
@@ -2131,6 +2329,10 @@ Nyx::post_regrid (int lbase,
 
 #ifdef GRAVITY
 
+    // The grids have changed, so the kept MLMG solvers are stale
+    if (level == lbase && do_grav)
+        gravity->clear_mlmg_cache();
+
     int which_level_being_advanced = parent->level_being_advanced();
 
     bool do_grav_solve_here;
@@ -2161,6 +2363,15 @@ Nyx::post_regrid (int lbase,
 #endif
     delete fine_mask;
     fine_mask = 0;
+
+#ifndef NO_HYDRO
+    // Tile sizes may have changed, so release the pooled CVODE workspaces and hydro scratch
+    if (level == lbase)
+    {
+        clear_cvode_workspace_pool();
+        HydroScratch::clear_all();
+    }
+#endif
 }
 
 void
@@ -2311,6 +2522,7 @@ Nyx::reflux ()
 
     BL_ASSERT(level<parent->finestLevel());
 
+    diag_eos_current = false;
     get_flux_reg(level+1).Reflux(get_new_data(State_Type), 1.0, 0, 0, NUM_STATE,
                                  geom);
 }
@@ -2425,6 +2637,9 @@ Nyx::average_down (int state_index)
         MultiFab& S_crse =          get_new_data(State_Type);
         MultiFab& S_fine = fine_lev.get_new_data(State_Type);
 
+        // Averaged Temp/Ne are not the EOS solution of the averaged (rho e)
+        diag_eos_current = false;
+
         amrex::average_down(S_fine, S_crse,
                             fgeom, cgeom,
                             0, S_fine.nComp(), fine_ratio);
@@ -2732,7 +2947,7 @@ Nyx::reset_internal_energy_nostore (MultiFab& S_new, MultiFab& D_new)
 
 #ifndef NO_HYDRO
 void
-Nyx::compute_new_temp (MultiFab& S_new, MultiFab& D_new)
+Nyx::compute_new_temp (MultiFab& S_new, MultiFab& D_new, Real* cfl_dt)
 {
     BL_PROFILE("Nyx::compute_new_temp()");
 
@@ -2743,12 +2958,23 @@ Nyx::compute_new_temp (MultiFab& S_new, MultiFab& D_new)
     if (heat_cool_type == 3 || heat_cool_type == 4 || heat_cool_type == 5 || heat_cool_type == 7 || heat_cool_type == 9 || heat_cool_type == 10 || heat_cool_type == 11 || heat_cool_type == 12)
     {
        const Real z = 1.0/a - 1.0;
-       fort_interp_to_this_z(&z);
+       AtomicRatesCache::interp_to_z(z);
     }
 #endif
 
     amrex::Gpu::synchronize();
     amrex::Gpu::LaunchSafeGuard lsg(true);
+
+    // Minimum of hydro_cell_dt, taken over each tile right after it is updated
+    ReduceOps<ReduceOpMin> reduce_op;
+    ReduceData<Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+
+    const auto dx = geom.CellSizeArray();
+    const Real sound_speed_factor = std::sqrt(gamma*(gamma-1));
+    const Real small_dens_in = small_dens;
+    const int  max_temp_dt_in = max_temp_dt;
+
     if (heat_cool_type == 7) {
 #ifdef _OPENMP
 #pragma omp parallel
@@ -2762,6 +2988,17 @@ Nyx::compute_new_temp (MultiFab& S_new, MultiFab& D_new)
                BL_TO_FORTRAN(S_new[mfi]),
                BL_TO_FORTRAN(D_new[mfi]), &a,
                &print_fortran_warnings);
+
+          if (cfl_dt)
+          {
+              const auto u = S_new.const_array(mfi);
+              reduce_op.eval(bx, reduce_data,
+              [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+              {
+                  return hydro_cell_dt(i, j, k, u, dx, sound_speed_factor,
+                                       small_dens_in, max_temp_dt_in);
+              });
+          }
         }
     }
     else
@@ -2849,6 +3086,17 @@ Nyx::compute_new_temp (MultiFab& S_new, MultiFab& D_new)
               }
 
             });
+
+            if (cfl_dt)
+            {
+                const auto u = S_new.const_array(mfi);
+                reduce_op.eval(bx, reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                {
+                    return hydro_cell_dt(i, j, k, u, dx, sound_speed_factor,
+                                         small_dens_in, max_temp_dt_in);
+                });
+            }
             amrex::Gpu::synchronize();
             /*
             fort_compute_temp_host
@@ -2868,6 +3116,12 @@ Nyx::compute_new_temp (MultiFab& S_new, MultiFab& D_new)
           }
       }
 
+    if (cfl_dt)
+    {
+        ReduceTuple hv = reduce_data.value();
+        *cfl_dt = amrex::get<0>(hv);
+    }
+
     // Find the cell which has the maximum temp -- but only if not the first
     // time step because in the first time step too many points have the same
     // value.
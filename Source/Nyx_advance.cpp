@@ -37,6 +37,10 @@ Nyx::advance (Real time,
 #ifndef NO_HYDRO
     if (do_hydro)
     {
+        // The new state is about to be rewritten on this level and any it advances with
+        for (int lev = level; lev <= parent->finestLevel(); lev++)
+            get_level(lev).diag_eos_current = false;
+
         if (Nyx::theActiveParticles().size() > 0)
         {
 #ifndef AGN
@@ -360,15 +364,10 @@ Nyx::advance_hydro_plus_particles (Real time,
 #ifdef GRAVITY
 
     //
-    // Here we use the "old" phi from the current time step as a guess for this
-    // solve
+    // Here we use the "old" phi from the current time step (extrapolated in
+    // time with gravity.phi_extrapolate) as a guess for this solve
     //
-    for (int lev = level; lev <= finest_level_to_advance; lev++)
-    {
-        MultiFab::Copy(parent->getLevel(lev).get_new_data(PhiGrav_Type),
-                       parent->getLevel(lev).get_old_data(PhiGrav_Type),
-                       0, 0, 1, 0);
-    }
+    gravity->make_new_phi_guess(level, finest_level_to_advance);
 
     // Solve for new Gravity
     BL_PROFILE_VAR("solve_for_new_phi", solve_for_new_phi);
@@ -421,7 +420,9 @@ Nyx::advance_hydro_plus_particles (Real time,
         reset_e_src.setVal(0.0);
         get_level(lev).reset_internal_energy(S_new,D_new,reset_e_src);
 
-        get_level(lev).compute_new_temp(S_new,D_new);
+        get_level(lev).compute_new_temp(S_new,D_new,&get_level(lev).hydro_cfl_dt);
+        get_level(lev).diag_eos_current = true;
+        get_level(lev).hydro_cfl_dt_current = true;
     }
 
     // Must average down again after doing the gravity correction;
@@ -560,7 +561,7 @@ Nyx::advance_hydro (Real time,
        // Solve for new phi
        // Here we use the "old" phi from the current time step as a guess for this solve
        //
-       MultiFab::Copy(get_new_data(PhiGrav_Type),get_old_data(PhiGrav_Type),0,0,1,0);
+       gravity->make_new_phi_guess(level, level);
        int fill_interior = 0;
        gravity->solve_for_new_phi(level,get_new_data(PhiGrav_Type),
                                   gravity->get_grad_phi_curr(level),fill_interior);
@@ -575,12 +576,18 @@ Nyx::advance_hydro (Real time,
     MultiFab& S_new = get_new_data(State_Type);
     MultiFab& D_new = get_new_data(DiagEOS_Type);
 
-    MultiFab reset_e_src(S_new.boxArray(), S_new.DistributionMap(), 1, NUM_GROW);
-    reset_e_src.setVal(0.0);
+    // Skipped when the heating/cooling integrator left Temp/Ne consistent with the state
+    if (!diag_eos_current)
+    {
+        MultiFab reset_e_src(S_new.boxArray(), S_new.DistributionMap(), 1, NUM_GROW);
+        reset_e_src.setVal(0.0);
 
-    // First reset internal energy before call to compute_temp
-    reset_internal_energy(S_new,D_new,reset_e_src);
-    compute_new_temp(S_new,D_new);
+        // First reset internal energy before call to compute_temp
+        reset_internal_energy(S_new,D_new,reset_e_src);
+        compute_new_temp(S_new,D_new,&hydro_cfl_dt);
+        diag_eos_current = true;
+        hydro_cfl_dt_current = true;
+    }
 
     return dt;
 }
@@ -598,6 +605,10 @@ Nyx::correct_gsrc(int lev, Real time, Real prev_time, Real cur_time, Real dt)
     const auto& ba = get_level(lev).get_new_data(State_Type).boxArray();
     const auto& dm = get_level(lev).get_new_data(State_Type).DistributionMap();
 
+#ifndef NO_HYDRO
+    get_level(lev).diag_eos_current = false;
+#endif
+
     // These vectors are only used for the call to correct_gsrc so they 
     //    don't need any ghost cells
     MultiFab grav_vec_old(ba, dm, BL_SPACEDIM, 0);
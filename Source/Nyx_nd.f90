@@ -428,6 +428,86 @@
 
       end subroutine fort_set_method_params
 
+! :::
+! ::: ----------------------------------------------------------------
+! :::
+
+      subroutine fort_get_riemann_params(gamma_out, small_dens_out, small_pres_out, &
+                                         riemann_solver_out, hybrid_riemann_out, &
+                                         use_analriem_out, use_csmall_gamma_out, &
+                                         use_gamma_minus_out, npass_max, npass_out, &
+                                         qpass_out, upass_out) &
+        bind(C, name="fort_get_riemann_params")
+
+        ! Passing the Riemann solver settings from f90 to the batched C++
+        ! solver; the passive maps come back 0-based
+
+        use amrex_fort_module, only : rt => amrex_real
+        use meth_params_module, only : gamma_minus_1, small_dens, small_pres, &
+                                       riemann_solver, hybrid_riemann, use_analriem, &
+                                       use_csmall_gamma, use_gamma_minus, &
+                                       npassive, qpass_map, upass_map
+
+        implicit none
+
+        real(rt), intent(out) :: gamma_out, small_dens_out, small_pres_out
+        integer,  intent(out) :: riemann_solver_out, hybrid_riemann_out
+        integer,  intent(out) :: use_analriem_out, use_csmall_gamma_out, use_gamma_minus_out
+        integer,  intent(in ) :: npass_max
+        integer,  intent(out) :: npass_out
+        integer,  intent(out) :: qpass_out(npass_max), upass_out(npass_max)
+
+        integer :: n
+
+        gamma_out            = gamma_minus_1 + 1.d0
+        small_dens_out       = small_dens
+        small_pres_out       = small_pres
+        riemann_solver_out   = riemann_solver
+        hybrid_riemann_out   = hybrid_riemann
+        use_analriem_out     = use_analriem
+        use_csmall_gamma_out = use_csmall_gamma
+        use_gamma_minus_out  = use_gamma_minus
+
+        npass_out = npassive
+        do n = 1, min(npassive, npass_max)
+           qpass_out(n) = qpass_map(n) - 1
+           upass_out(n) = upass_map(n) - 1
+        end do
+
+      end subroutine fort_get_riemann_params
+
+! :::
+! ::: ----------------------------------------------------------------
+! :::
+
+      subroutine fort_get_hydro_kernel_params(iorder_out, use_pslope_out, &
+                                              use_gamma_minus_out, use_srcQ_in_trace_out, &
+                                              use_pressure_law_pdivu_out, &
+                                              use_area_dt_scale_apply_out) &
+        bind(C, name="fort_get_hydro_kernel_params")
+
+        ! Passing the options the C++ trace and consup kernels are
+        ! specialized on from f90
+
+        use meth_params_module, only : iorder, use_pslope, use_gamma_minus, &
+                                       use_srcQ_in_trace, use_pressure_law_pdivu, &
+                                       use_area_dt_scale_apply
+
+        implicit none
+
+        integer, intent(out) :: iorder_out, use_pslope_out
+        integer, intent(out) :: use_gamma_minus_out, use_srcQ_in_trace_out
+        integer, intent(out) :: use_pressure_law_pdivu_out, use_area_dt_scale_apply_out
+
+        iorder_out                  = iorder
+        use_pslope_out              = use_pslope
+        use_gamma_minus_out         = use_gamma_minus
+        use_srcQ_in_trace_out       = use_srcQ_in_trace
+        use_pressure_law_pdivu_out  = use_pressure_law_pdivu
+        use_area_dt_scale_apply_out = use_area_dt_scale_apply
+
+      end subroutine fort_get_hydro_kernel_params
+
 ! :::
 ! ::: ----------------------------------------------------------------
 ! :::
@@ -449,6 +529,23 @@
 
       end subroutine fort_set_eos_params
 
+! :::
+! ::: ----------------------------------------------------------------
+! :::
+
+      subroutine fort_set_heat_cool_type(heat_cool_in) &
+        bind(C, name="fort_set_heat_cool_type")
+
+        use meth_params_module, only : heat_cool_type
+
+        implicit none
+
+        integer, intent(in) :: heat_cool_in
+
+        heat_cool_type = heat_cool_in
+
+      end subroutine fort_set_heat_cool_type
+
 ! :::
 ! ::: ----------------------------------------------------------------
 ! :::
@@ -85,6 +85,11 @@ DarkMatterParticleContainer::moveKickDrift (amrex::MultiFab&       acceleration,
     //If there are no particles at this level
     if (lev >= this->GetParticles().size())
         return;
+
+    // The old time force, kicking from a_old to a_half
+    if (m_p3m_split > 0)
+        shortRangeKick(lev, 0.5 * dt, a_old, a_old);
+
     const GpuArray<Real,AMREX_SPACEDIM> dx = Geom(lev).CellSizeArray();
     const auto dxi              = Geom(lev).InvCellSizeArray();
 
@@ -189,6 +194,10 @@ DarkMatterParticleContainer::moveKick (MultiFab&       acceleration,
 {
     BL_PROFILE("DarkMatterParticleContainer::moveKick()");
 
+    // The new time force, kicking from a_half to a_new
+    if (m_p3m_split > 0 && lev < this->GetParticles().size())
+        shortRangeKick(lev, 0.5 * dt, a_new, a_half);
+
     const GpuArray<Real,AMREX_SPACEDIM> dx = Geom(lev).CellSizeArray();
     const auto dxi              = Geom(lev).InvCellSizeArray();
 
@@ -245,6 +254,136 @@ DarkMatterParticleContainer::moveKick (MultiFab&       acceleration,
     if (ac_ptr != &acceleration) delete ac_ptr;
 }
 
+void
+DarkMatterParticleContainer::shortRangeKick (int  lev,
+                                             Real half_dt,
+                                             Real a_force,
+                                             Real a_prev)
+{
+    BL_PROFILE("DarkMatterParticleContainer::shortRangeKick()");
+
+    const Real*   dx   = Geom(lev).CellSize();
+    const auto    dxi  = Geom(lev).InvCellSizeArray();
+    const auto    plo  = Geom(lev).ProbLoArray();
+    const IntVect base = Geom(lev).Domain().smallEnd();
+
+    const int  ncut  = static_cast<int>(std::ceil(m_p3m_split));
+    const Real split = m_p3m_split * dx[0];
+    const Real eps2  = (m_p3m_softening * dx[0]) * (m_p3m_softening * dx[0]);
+
+    // The kick is (a_prev * v + half_dt * g) / a_cur, and the point mass
+    // potential carries the 1/a of the Poisson RHS
+    const Real fac = half_dt * m_p3m_Gconst / (a_force * a_prev);
+
+    // Force between two S2 clouds of diameter split at distance r, per unit
+    // G m m (Hockney & Eastwood, eq. 8-22)
+    auto s2_force = [split] (Real r) -> Real
+    {
+        const Real xi  = 2.0 * r / split;
+        const Real xi2 = xi*xi;
+        const Real xi3 = xi2*xi;
+        if (xi < 1.0)
+            return (224.*xi - 224.*xi3 + 70.*xi3*xi + 48.*xi3*xi2 - 21.*xi3*xi3) / (35.*split*split);
+        else if (xi < 2.0)
+            return (12./xi2 - 224. + 896.*xi - 840.*xi2 + 224.*xi3 + 70.*xi3*xi
+                    - 48.*xi3*xi2 + 7.*xi3*xi3) / (35.*split*split);
+        return 1.0 / (r*r);
+    };
+
+    amrex::Gpu::Device::streamSynchronize();
+
+    // Copies of the particles within ncut cells of each grid
+    fillNeighbors();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<int> head, next;
+
+        for (MyParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            AoS& particles = pti.GetArrayOfStructs();
+            ParticleType* pstruct = particles().data();
+            const int np = particles.size();
+
+            PairIndex index(pti.index(), pti.LocalTileIndex());
+            auto nbor = neighbors[lev].find(index);
+            const int ng = (nbor == neighbors[lev].end()) ? 0 : nbor->second.size() / pdata_size;
+            const ParticleType* nstruct = (ng > 0) ?
+                reinterpret_cast<const ParticleType*>(nbor->second.dataPtr()) : nullptr;
+
+            auto part = [&] (int n) -> const ParticleType& { return (n < np) ? pstruct[n] : nstruct[n-np]; };
+
+            // Cell linked list of the particles and their neighbors
+            const Box bx = amrex::grow(pti.tilebox(), ncut+1);
+
+            auto cell_of = [&] (const ParticleType& p) -> IntVect
+            {
+                return IntVect(AMREX_D_DECL(static_cast<int>(std::floor((p.pos(0)-plo[0])*dxi[0])),
+                                            static_cast<int>(std::floor((p.pos(1)-plo[1])*dxi[1])),
+                                            static_cast<int>(std::floor((p.pos(2)-plo[2])*dxi[2])))) + base;
+            };
+
+            head.assign(bx.numPts(), -1);
+            next.assign(np+ng, -1);
+            for (int n = 0; n < np+ng; n++)
+            {
+                const ParticleType& p = part(n);
+                if (p.id() <= 0) continue;
+                const IntVect iv = cell_of(p);
+                if (!bx.contains(iv)) continue;
+                const long c = bx.index(iv);
+                next[n] = head[c];
+                head[c] = n;
+            }
+
+            for (int i = 0; i < np; i++)
+            {
+                ParticleType& p = pstruct[i];
+                if (p.id() <= 0) continue;
+
+                const IntVect iv = cell_of(p);
+                if (!bx.contains(iv)) continue;
+
+                const Box search = amrex::grow(Box(iv,iv), ncut) & bx;
+
+                Real acc[BL_SPACEDIM] = {AMREX_D_DECL(0.0, 0.0, 0.0)};
+
+                for (IntVect jv = search.smallEnd(); jv <= search.bigEnd(); search.next(jv))
+                {
+                    for (int n = head[bx.index(jv)]; n >= 0; n = next[n])
+                    {
+                        if (n == i) continue;
+                        const ParticleType& q = part(n);
+
+                        Real d[BL_SPACEDIM];
+                        Real r2 = 0.0;
+                        for (int dir = 0; dir < BL_SPACEDIM; dir++)
+                        {
+                            d[dir] = q.pos(dir) - p.pos(dir);
+                            r2 += d[dir]*d[dir];
+                        }
+                        if (r2 >= split*split || r2 == 0.0) continue;
+
+                        const Real r     = std::sqrt(r2);
+                        const Real soft  = r / ((r2 + eps2) * std::sqrt(r2 + eps2));
+                        const Real f_r   = q.rdata(0) * (soft - s2_force(r)) / r;
+
+                        for (int dir = 0; dir < BL_SPACEDIM; dir++)
+                            acc[dir] += f_r * d[dir];
+                    }
+                }
+
+                for (int dir = 0; dir < BL_SPACEDIM; dir++)
+                    p.rdata(dir+1) += fac * acc[dir];
+            }
+        }
+    }
+
+    clearNeighbors();
+}
+
 //template <typename P>
 AMREX_GPU_HOST_DEVICE AMREX_INLINE void DarkMatterParticleContainer::update_dm_particle_single (ParticleType&  p,
                                      const int nc,
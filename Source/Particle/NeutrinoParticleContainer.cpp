@@ -154,6 +154,41 @@ NeutrinoParticleContainer::AssignRelativisticDensity (Vector<std::unique_ptr<Mul
     }
 }
 
+void
+NeutrinoParticleContainer::DepositMass (MultiFab& mf,
+                                        int       lev,
+                                        int       particle_lvl_offset) const
+{
+    BL_PROFILE("NeutrinoParticleContainer::DepositMass()");
+
+    if (!m_relativistic)
+    {
+        NyxParticleContainer<2+BL_SPACEDIM>::DepositMass(mf, lev, particle_lvl_offset);
+        return;
+    }
+
+    const auto plo  = Geom(lev).ProbLoArray();
+    const auto dxi  = Geom(lev).InvCellSizeArray();
+    const auto pdxi = Geom(lev + particle_lvl_offset).InvCellSizeArray();
+
+    if (particle_lvl_offset == 0)
+    {
+        DepositMassWith(mf, lev,
+        [=] AMREX_GPU_DEVICE (const ParticleType& p, Array4<Real> const& rho)
+        {
+            neutrino_deposit_relativistic_mass_cic(p, rho, plo, dxi);
+        });
+    }
+    else
+    {
+        DepositMassWith(mf, lev,
+        [=] AMREX_GPU_DEVICE (const ParticleType& p, Array4<Real> const& rho)
+        {
+            neutrino_deposit_particle_dx_relativistic_mass_cic(p, rho, plo, dxi, pdxi);
+        });
+    }
+}
+
 //
 // This is the single-level version for cell-centered density
 //
@@ -258,8 +293,8 @@ NeutrinoParticleContainer::AssignRelativisticDensitySingleLevel (MultiFab& mf_to
                     AMREX_FOR_1D( np, i,
                     {
                         neutrino_deposit_particle_dx_relativistic_cic(pstruct[i],
-                                                                      rhoarr, plo, dxi);
-                    }
+                                                                      rhoarr, plo, dxi, pdxi);
+                    });
                 } else {
                 AMREX_FOR_1D( np, i,
                 {
@@ -0,0 +1,119 @@
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_PhysBCFunct.H>
+
+#include "NyxParticleContainer.H"
+
+using namespace amrex;
+
+void
+NyxParticleContainerBase::AssignTotalDensitySingleLevel (const Vector<NyxParticleContainerBase*>& pcs,
+                                                         MultiFab&       mf,
+                                                         int             lev,
+                                                         const Geometry& geom,
+                                                         int             particle_lvl_offset)
+{
+    BL_PROFILE("NyxParticleContainerBase::AssignTotalDensitySingleLevel()");
+
+    mf.setVal(0.0);
+
+    for (int i = 0; i < pcs.size(); i++)
+        pcs[i]->DepositMass(mf, lev, particle_lvl_offset);
+
+    // The mass in the ghost cells of one grid goes to the valid cells of its
+    // neighbours, once for all of pcs
+    mf.SumBoundary(geom.periodicity());
+
+    // Convert mass to density
+    const Real* dx = geom.CellSize();
+    const Real vol = AMREX_D_TERM(dx[0], *dx[1], *dx[2]);
+
+    mf.mult(1.0/vol, 0, 1, mf.nGrow());
+}
+
+void
+NyxParticleContainerBase::AssignTotalDensity (const Vector<NyxParticleContainerBase*>& pcs,
+                                              Vector<std::unique_ptr<MultiFab> >& mf,
+                                              Amr* amr,
+                                              int  lev_min,
+                                              int  finest_level,
+                                              int  ngrow)
+{
+    BL_PROFILE("NyxParticleContainerBase::AssignTotalDensity()");
+
+    mf.resize(finest_level+1);
+    for (int lev = lev_min; lev <= finest_level; lev++)
+    {
+        auto ng = lev == lev_min ? IntVect(AMREX_D_DECL(ngrow,ngrow,ngrow)) : amr->refRatio(lev-1);
+        mf[lev].reset(new MultiFab(amr->boxArray(lev), amr->DistributionMap(lev), 1, ng));
+        AssignTotalDensitySingleLevel(pcs, *mf[lev], lev, amr->Geom(lev));
+    }
+
+    //
+    // The same coarse/fine treatment as ParticleContainer::AssignDensity:
+    // coarse particle mass over a fine level is interpolated onto it, fine
+    // particle mass outside the fine grids is summed onto the coarse level
+    // and the coarse cells under the fine level are then averaged down
+    //
+    if (finest_level > lev_min)
+    {
+        int lo_bc[] = {BCType::int_dir, BCType::int_dir, BCType::int_dir}; // periodic boundaries
+        int hi_bc[] = {BCType::int_dir, BCType::int_dir, BCType::int_dir};
+        Vector<BCRec> bcs(1, BCRec(lo_bc, hi_bc));
+        PCInterp mapper;
+
+        Vector<std::unique_ptr<MultiFab> > tmp(finest_level+1);
+        for (int lev = lev_min; lev <= finest_level; ++lev)
+        {
+            tmp[lev].reset(new MultiFab(mf[lev]->boxArray(), mf[lev]->DistributionMap(), 1, 0));
+            tmp[lev]->setVal(0.0);
+        }
+
+        for (int lev = lev_min; lev <= finest_level; ++lev)
+        {
+            if (lev < finest_level)
+            {
+                PhysBCFunct<BndryFuncArray> cphysbc(amr->Geom(lev), bcs,
+                                                    BndryFuncArray([](Real* data,
+                                                                      AMREX_ARLIM_P(lo), AMREX_ARLIM_P(hi),
+                                                                      const int* dom_lo, const int* dom_hi,
+                                                                      const Real* dx, const Real* grd_lo,
+                                                                      const Real* time, const int* bc){}));
+                PhysBCFunct<BndryFuncArray> fphysbc(amr->Geom(lev+1), bcs,
+                                                    BndryFuncArray([](Real* data,
+                                                                      AMREX_ARLIM_P(lo), AMREX_ARLIM_P(hi),
+                                                                      const int* dom_lo, const int* dom_hi,
+                                                                      const Real* dx, const Real* grd_lo,
+                                                                      const Real* time, const int* bc){}));
+
+                amrex::InterpFromCoarseLevel(*tmp[lev+1], 0.0, *mf[lev], 0, 0, 1,
+                                             amr->Geom(lev), amr->Geom(lev+1),
+                                             cphysbc, 0, fphysbc, 0,
+                                             amr->refRatio(lev), &mapper, bcs, 0);
+            }
+
+            if (lev > lev_min)
+            {
+                // Note - this will double count the mass on the coarse level in
+                // regions covered by the fine level, but this will be corrected
+                // below in the call to average_down.
+                amrex::sum_fine_to_coarse(*mf[lev], *mf[lev-1], 0, 1, amr->refRatio(lev-1),
+                                          amr->Geom(lev-1), amr->Geom(lev));
+            }
+
+            mf[lev]->plus(*tmp[lev], 0, 1, 0);
+        }
+
+        for (int lev = finest_level - 1; lev >= lev_min; --lev)
+            amrex::average_down(*mf[lev+1], *mf[lev], 0, 1, amr->refRatio(lev));
+    }
+
+    if (lev_min > 0)
+    {
+        int nlevels = finest_level - lev_min + 1;
+        for (int i = 0; i < nlevels; i++)
+            mf[i] = std::move(mf[i+lev_min]);
+        mf.resize(nlevels);
+    }
+}
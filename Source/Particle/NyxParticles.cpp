@@ -4,6 +4,9 @@
 #ifdef GRAVITY
 #include <Gravity.H>
 #include <Gravity_F.H> //needed for get_grav_constant, but there might be a better way
+
+extern "C"
+{ void fort_get_grav_const(amrex::Real* Gconst); }
 #endif
 
 #include <Nyx_F.H>
@@ -13,6 +16,26 @@ using namespace amrex;
 namespace
 {
     bool virtual_particles_set = false;
+
+    //
+    // The active dark matter container, with the neighbor cells and pair
+    // force of particles.p3m when it is on
+    //
+    DarkMatterParticleContainer* new_dm_particle_container (Amr* amr)
+    {
+        if (!Nyx::particle_p3m)
+            return new DarkMatterParticleContainer(amr);
+
+        const int nghost = static_cast<int>(std::ceil(Nyx::particle_p3m_split));
+        DarkMatterParticleContainer* pc = new DarkMatterParticleContainer(amr, nghost);
+
+        Real Gconst = 0;
+#ifdef GRAVITY
+        fort_get_grav_const(&Gconst);
+#endif
+        pc->SetShortRangeForce(Nyx::particle_p3m_split, Nyx::particle_p3m_softening, Gconst);
+        return pc;
+    }
     
     std::string ascii_particle_file;
     std::string binary_particle_file;
@@ -157,6 +180,10 @@ Real Nyx::particle_cfl = 0.5;
 Real Nyx::neutrino_cfl = 0.5;
 #endif
 
+int  Nyx::particle_p3m           = 0;
+Real Nyx::particle_p3m_split     = 3.0;
+Real Nyx::particle_p3m_softening = 0.05;
+
 IntVect Nyx::Nrep;
 
 Vector<NyxParticleContainerBase*>&
@@ -380,6 +407,22 @@ Nyx::read_particle_params ()
 #ifdef NEUTRINO_PARTICLES
     ppp.query("neutrino_cfl", neutrino_cfl);
 #endif
+    //
+    // Short-range particle-particle correction to the dark matter mesh force
+    // within p3m_split cells, with a Plummer softening of p3m_softening cells
+    //
+    ppp.query("p3m", particle_p3m);
+    ppp.query("p3m_split", particle_p3m_split);
+    ppp.query("p3m_softening", particle_p3m_softening);
+
+    if (particle_p3m)
+    {
+#ifndef GRAVITY
+        amrex::Abort("Nyx::read_particle_params(): particles.p3m needs GRAVITY");
+#endif
+        if (particle_p3m_split <= 0 || particle_p3m_softening < 0)
+            amrex::Abort("Nyx::read_particle_params(): need particles.p3m_split > 0 and p3m_softening >= 0");
+    }
 }
 
 void
@@ -397,8 +440,8 @@ Nyx::init_particles ()
     if (do_dm_particles)
     {
         BL_ASSERT (DMPC == 0);
-        DMPC = new DarkMatterParticleContainer(parent);
-        ActiveParticles.push_back(DMPC); 
+        DMPC = new_dm_particle_container(parent);
+        ActiveParticles.push_back(DMPC);
 
         if (init_with_sph_particles == 1)
            SPHPC = new DarkMatterParticleContainer(parent);
@@ -908,7 +951,7 @@ Nyx::particle_post_restart (const std::string& restart_file, bool is_checkpoint)
     if (do_dm_particles)
     {
         BL_ASSERT(DMPC == 0);
-        DMPC = new DarkMatterParticleContainer(parent);
+        DMPC = new_dm_particle_container(parent);
         ActiveParticles.push_back(DMPC);
 
         if (parent->subCycle())
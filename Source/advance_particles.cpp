@@ -219,15 +219,12 @@ Nyx::advance_particles_only (Real time,
     }
 
     //
-    // Here we use the "old" phi from the current time step as a guess for this
-    // solve
+    // Here we use the "old" phi from the current time step (extrapolated in
+    // time with gravity.phi_extrapolate) as a guess for this solve
     //
-    for (int lev = level; lev <= finest_level_to_advance; lev++)
     {
         amrex::Gpu::LaunchSafeGuard lsg(true);
-        MultiFab::Copy(parent->getLevel(lev).get_new_data(PhiGrav_Type),
-                       parent->getLevel(lev).get_old_data(PhiGrav_Type),
-                       0, 0, 1, 0);
+        gravity->make_new_phi_guess(level, finest_level_to_advance);
     }
     }
 
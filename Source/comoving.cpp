@@ -1,6 +1,7 @@
 #include <iomanip>
 #include "Nyx.H"
 #include "Nyx_F.H"
+#include "AtomicRatesCache.H"
 
 using namespace amrex;
 
@@ -567,6 +568,36 @@ Nyx::integrate_time_given_a(const Real a0, const Real a1, Real& dt)
     }
 }
 
+Real
+Nyx::get_growth_factor (Real a)
+{
+    // No growth to speak of without a matter dominated expansion
+    if (comoving_type <= 0 || comoving_h == 0.0 || comoving_OmM <= 0.0)
+        return a;
+
+    const Real OmM = comoving_OmM;
+    const Real OmR = comoving_OmR;
+    const Real OmL = 1.e0 - OmM - OmR;
+
+    // D(a) = E(a) int_0^a da' / (a' E(a'))^3 with E = H / H_0, by Simpson's
+    // rule; the integrand goes to zero as a' goes to zero
+    auto integrand = [=] (Real x) -> Real
+    {
+        if (x <= 0.0) return 0.0;
+        const Real xE = std::sqrt(OmM/x + OmR/(x*x) + OmL*x*x);
+        return 1.0 / (xE*xE*xE);
+    };
+
+    const int  n = 512;
+    const Real h = a / n;
+    Real sum = integrand(0.0) + integrand(a);
+    for (int j = 1; j < n; j++)
+        sum += ((j % 2) ? 4.0 : 2.0) * integrand(j*h);
+
+    const Real E = std::sqrt(OmM/(a*a*a) + OmR/(a*a*a*a) + OmL);
+    return E * sum * h / 3.0;
+}
+
 void
 Nyx::integrate_comoving_a (const Real old_a, Real& new_a, const Real dt)
 {
@@ -662,7 +693,7 @@ Nyx::comoving_a_post_restart (const std::string& restart_file)
      // Initialize "this_z" in the atomic_rates_module
      if (heat_cool_type == 1 || heat_cool_type == 3 || heat_cool_type == 4 || heat_cool_type == 5 || heat_cool_type == 7 || heat_cool_type==9 || heat_cool_type==10 || heat_cool_type == 11 || heat_cool_type == 12) {
          Real old_z = 1.0/old_a - 1.0;
-         fort_interp_to_this_z(&old_z);
+         AtomicRatesCache::interp_to_z(old_z);
      }
 #endif
 }
@@ -1,5 +1,7 @@
 #include "Nyx.H"
 #include "Nyx_F.H"
+#include "BoundaryFluxes.H"
+#include "HydroStageTimers.H"
 
 using namespace amrex;
 
@@ -16,12 +18,8 @@ Nyx::compute_hydro_sources(amrex::Real time, amrex::Real dt, amrex::Real a_old,
     const int finest_level = parent->finestLevel();
     const Real* dx = geom.CellSize();
 
-    MultiFab fluxes[BL_SPACEDIM];
-    for (int j = 0; j < BL_SPACEDIM; j++)
-    {
-        fluxes[j].define(getEdgeBoxArray(j), dmap, NUM_STATE, 0);
-        fluxes[j].setVal(0.0);
-    }
+    // Only the faces the flux registers read are kept
+    BoundaryFluxes fluxes;
 
     //
     // Get pointers to Flux registers, or set pointer to zero if not there.
@@ -41,8 +39,22 @@ Nyx::compute_hydro_sources(amrex::Real time, amrex::Real dt, amrex::Real a_old,
        if (level > 0) {
          current = &get_flux_reg(level);
        }
+       if (add_to_flux_register)
+         fluxes.define(grids, dmap, NUM_STATE, current != 0,
+                       fine ? &parent->boxArray(level+1) : nullptr,
+                       fine ? parent->refRatio(level) : IntVect::TheUnitVector());
     }
 
+    // If the ghost-cell exchange is still in flight (nyx.hydro_overlap_fill),
+    // the cells of each tile that only read valid cells go first and the strips
+    // around them wait for it
+    const int npasses = hydro_fill_pending ? 2 : 1;
+
+    for (int pass = 0; pass < npasses; ++pass)
+    {
+    if (pass == 1)
+        hydro_fill_finish(S_border, D_border);
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -51,7 +63,11 @@ Nyx::compute_hydro_sources(amrex::Real time, amrex::Real dt, amrex::Real a_old,
 
     for (MFIter mfi(S_border,true); mfi.isValid(); ++mfi)
     {
-        const Box& bx        = mfi.tilebox();
+      for (const Box& bx : hydro_pass_boxes(mfi, npasses, pass))
+      {
+        // The Fortran hydro is timed as a single stage
+        HydroStageTimer stage_timer;
+        stage_timer.mark(HydroStageTimers::FortranHydro);
 
         FArrayBox& state     = S_border[mfi];
         FArrayBox& dstate    = D_border[mfi];
@@ -82,25 +98,18 @@ Nyx::compute_hydro_sources(amrex::Real time, amrex::Real dt, amrex::Real a_old,
              &print_fortran_warnings);
 
         for (int i = 0; i < BL_SPACEDIM; ++i) 
-          fluxes[i][mfi].copy<RunOn::Host>(flux[i], mfi.nodaltilebox(i));
-        
+          fluxes.store(mfi, bx, i, flux[i]);
+
+      } // end of pass boxes loop
     } // end of MFIter loop
 
     } // end of parallel
 
+    } // end of pass loop
+
     if (add_to_flux_register)
     {
-       if (do_reflux) {
-         if (current) {
-           for (int i = 0; i < BL_SPACEDIM ; i++) {
-             current->FineAdd(fluxes[i], i, 0, 0, NUM_STATE, 1);
-           }
-         }
-         if (fine) {
-           for (int i = 0; i < BL_SPACEDIM ; i++) {
-                 fine->CrseInit(fluxes[i],i,0,0,NUM_STATE,-1.,FluxRegister::ADD);
-           }
-         }
-       }
+       if (do_reflux)
+         fluxes.add_to_registers(current, fine);
     }
 }
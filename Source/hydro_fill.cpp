@@ -0,0 +1,77 @@
+#include "Nyx.H"
+
+using namespace amrex;
+
+//
+// Ghost-cell fill of the hydro inputs, with an overlapped mode
+// (nyx.hydro_overlap_fill = 1).
+//
+// On level 0 of a periodic domain, FillPatch at the old time only copies the
+// old data and exchanges the ghost cells: nothing is interpolated in time or
+// space and there are no physical boundaries. In that case the overlapped
+// mode copies the valid data here and leaves the exchange for later.
+// hydro_fill_post starts it without waiting. The hydro drivers then do the
+// interior of each box, whose stencil reads no ghost cells, call
+// hydro_fill_finish, and do the strips along the box faces.
+//
+// Returns true if the ghost cells were left for hydro_fill_post.
+//
+bool
+Nyx::fill_hydro_inputs (MultiFab& S_border, MultiFab& D_border, Real time)
+{
+    const Real prev_time = state[State_Type].prevTime();
+    const Real cur_time  = state[State_Type].curTime();
+
+    // Same tolerance as StateData uses to pick the old data
+    const bool at_old_time = std::abs(time - prev_time) <= 1.e-3*(cur_time - prev_time);
+
+    if (hydro_overlap_fill == 0 || level != 0 || !geom.isAllPeriodic() || !at_old_time)
+    {
+        FillPatch(*this, S_border, S_border.nGrow(), time, State_Type, 0, S_border.nComp());
+        FillPatch(*this, D_border, D_border.nGrow(), time, DiagEOS_Type, 0, D_border.nComp());
+        return false;
+    }
+
+    MultiFab::Copy(S_border, get_old_data(State_Type),   0, 0, S_border.nComp(), 0);
+    MultiFab::Copy(D_border, get_old_data(DiagEOS_Type), 0, 0, D_border.nComp(), 0);
+    return true;
+}
+
+void
+Nyx::hydro_fill_post (MultiFab& S_border, MultiFab& D_border)
+{
+    BL_PROFILE("Nyx::hydro_fill_post()");
+
+    S_border.FillBoundary_nowait(geom.periodicity());
+    D_border.FillBoundary_nowait(geom.periodicity());
+    hydro_fill_pending = true;
+}
+
+void
+Nyx::hydro_fill_finish (MultiFab& S_border, MultiFab& D_border)
+{
+    if (!hydro_fill_pending) return;
+
+    BL_PROFILE("Nyx::hydro_fill_finish()");
+
+    S_border.FillBoundary_finish();
+    D_border.FillBoundary_finish();
+    hydro_fill_pending = false;
+}
+
+// The part of this tile done in pass `pass` of npasses: with the exchange in
+// flight (npasses == 2), pass 0 gets the cells whose hydro stencil stays inside
+// the box's valid region and pass 1 the strips of the tile around them
+BoxList
+Nyx::hydro_pass_boxes (const MFIter& mfi, int npasses, int pass)
+{
+    const Box& tbx = mfi.tilebox();
+    if (npasses == 1)
+        return BoxList(tbx);
+
+    const Box interior = amrex::grow(mfi.validbox(), -NUM_GROW) & tbx;
+    if (pass == 0)
+        return interior.ok() ? BoxList(interior) : BoxList();
+
+    return interior.ok() ? amrex::boxDiff(tbx, interior) : BoxList(tbx);
+}
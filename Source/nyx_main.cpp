@@ -22,6 +22,9 @@
 #include <MemInfo.H>
 #endif
 #include <Nyx.H>
+#ifndef NO_HYDRO
+#include <HydroStageTimers.H>
+#endif
 
 #ifdef REEBER
 #ifdef REEBER_HIST
@@ -200,6 +203,11 @@ nyx_main (int argc, char* argv[])
         std::cout << "Run time = " << dRunTime2 << std::endl;
     }
 
+#ifndef NO_HYDRO
+    if (HydroStageTimers::on())
+        HydroStageTimers::print();
+#endif
+
     BL_PROFILE_VAR_STOP(pmain);
     BL_PROFILE_REGION_STOP("main()");
     BL_PROFILE_SET_RUN_TIME(dRunTime2);
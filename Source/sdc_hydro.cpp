@@ -1,6 +1,7 @@
 
 #include "Nyx.H"
 #include "Nyx_F.H"
+#include "HydroStageTimers.H"
 
 using namespace amrex;
 
@@ -57,10 +58,12 @@ Nyx::sdc_hydro (Real time,
 
     // Create FAB for extended grid values (including boundaries) and fill.
     MultiFab S_old_tmp(S_old.boxArray(), S_old.DistributionMap(), NUM_STATE, NUM_GROW);
-    FillPatch(*this, S_old_tmp, NUM_GROW, time, State_Type, 0, NUM_STATE);
-
     MultiFab D_old_tmp(D_old.boxArray(), D_old.DistributionMap(), D_old.nComp(), NUM_GROW);
-    FillPatch(*this, D_old_tmp, NUM_GROW, time, DiagEOS_Type, 0, D_old.nComp());
+
+    // With nyx.hydro_overlap_fill the ghost cells are exchanged while
+    // compute_hydro_sources does the interior tiles
+    if (fill_hydro_inputs(S_old_tmp, D_old_tmp, time))
+        hydro_fill_post(S_old_tmp, D_old_tmp);
 
     MultiFab hydro_src(grids, dmap, NUM_STATE, 0);
     hydro_src.setVal(0.);
@@ -100,6 +103,8 @@ Nyx::sdc_hydro (Real time,
        update_state_with_sources(S_old_tmp,S_new,
                                  ext_src_old,hydro_src,grav_vector,divu_cc,
                                  dt,a_old,a_new);
+       if (sdc_iter == 0)
+           HydroStageTimers::add_cells(grids.numPts());
 
        // We copy old Temp and Ne to new Temp and Ne so that they can be used
        //    as guesses when we next need them.
@@ -1,6 +1,7 @@
 
 #include "Nyx.H"
 #include "Nyx_F.H"
+#include "AtomicRatesCache.H"
 
 using namespace amrex;
 using std::string;
@@ -24,7 +25,7 @@ Nyx::sdc_reactions (MultiFab& S_old, MultiFab& S_new, MultiFab& D_new,
 #ifndef FORCING
     {
       const Real z = 1.0/a_old - 1.0;
-      fort_interp_to_this_z(&z);
+      AtomicRatesCache::interp_to_z(z);
     }
 #endif
 
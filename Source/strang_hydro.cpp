@@ -1,6 +1,7 @@
 
 #include "Nyx.H"
 #include "Nyx_F.H"
+#include "HydroStageTimers.H"
 
 #ifdef GRAVITY
 #include "Gravity.H"
@@ -97,8 +98,9 @@ Nyx::strang_hydro (Real time,
     MultiFab S_old_tmp(S_old.boxArray(), S_old.DistributionMap(), NUM_STATE, NUM_GROW);
     MultiFab D_old_tmp(D_old.boxArray(), D_old.DistributionMap(), D_old.nComp(), NUM_GROW);
 
-    FillPatch(*this, S_old_tmp, NUM_GROW, time, State_Type, 0, NUM_STATE);
-    FillPatch(*this, D_old_tmp, NUM_GROW, time, DiagEOS_Type, 0, D_old.nComp());
+    // With nyx.hydro_overlap_fill this may only fill the valid cells; the
+    // ghost cells are then exchanged while the hydro does the interior tiles
+    bool ghosts_deferred = fill_hydro_inputs(S_old_tmp, D_old_tmp, time);
 
     BL_PROFILE_VAR_STOP(old_tmp);
 
@@ -126,16 +128,33 @@ Nyx::strang_hydro (Real time,
       amrex::Print()<<"Before first strang:"<<std::endl;
       amrex::Arena::PrintUsage();
     }
-    strang_first_step(time,dt,S_old_tmp,D_old_tmp);
+    // Only the integrators that do the valid cells alone can run before
+    // the exchange; the others need the ghost cells first
+    const bool strang_valid_only = strang_grown_box != 1 &&
+        (heat_cool_type == 10 || heat_cool_type == 11 || heat_cool_type == 12);
+    if (ghosts_deferred && !strang_valid_only)
+    {
+        hydro_fill_post(S_old_tmp, D_old_tmp);
+        hydro_fill_finish(S_old_tmp, D_old_tmp);
+        ghosts_deferred = false;
+    }
+    strang_first_step(time,dt,S_old_tmp,D_old_tmp,!ghosts_deferred);
 #endif
 
+    if (ghosts_deferred)
+        hydro_fill_post(S_old_tmp, D_old_tmp);
+
     bool   init_flux_register = true;
     bool add_to_flux_register = true;
 
     MultiFab hydro_src(grids, dmap, NUM_STATE, 0);
     hydro_src.setVal(0.);
 
-    if(hydro_convert)
+    if(hydro_convert && hydro_mol)
+      construct_mol_hydro_source(time,dt,a_old,a_new,S_old_tmp,D_old_tmp,
+                                 ext_src_old,hydro_src,grav_vector,
+                                 init_flux_register, add_to_flux_register);
+    else if(hydro_convert)
       construct_ctu_hydro_source(time,dt,a_old,a_new,S_old_tmp,D_old_tmp,
                                  ext_src_old,hydro_src,grav_vector,
                                  init_flux_register, add_to_flux_register);
@@ -153,6 +172,7 @@ Nyx::strang_hydro (Real time,
     update_state_with_sources(S_old_tmp,S_new,
                               ext_src_old,hydro_src,grav_vector,*divu_cc,
                               dt,a_old,a_new);  
+    HydroStageTimers::add_cells(grids.numPts());
 
     S_old_tmp.clear();
     hydro_src.clear();
@@ -379,7 +399,13 @@ Nyx::strang_hydro_ghost_state (Real time,
 
     MultiFab hydro_src(grids, dmap, NUM_STATE, 0);
 
-    if(hydro_convert)
+    if(hydro_convert && hydro_mol)
+      {
+        construct_mol_hydro_source(time,dt,a_old,a_new,S_new,D_old_tmp,
+                                 ext_src_old,hydro_src,grav_vector,
+                                 init_flux_register, add_to_flux_register);
+      }
+    else if(hydro_convert)
       {
         construct_ctu_hydro_source(time,dt,a_old,a_new,S_new,D_old_tmp,
                                  ext_src_old,hydro_src,grav_vector,
@@ -398,6 +424,7 @@ Nyx::strang_hydro_ghost_state (Real time,
     update_state_with_sources(S_new,S_new,
                               ext_src_old,hydro_src,grav_vector,*divu_cc,
                               dt,a_old,a_new);  
+    HydroStageTimers::add_cells(grids.numPts());
 
     hydro_src.clear();
 
@@ -1,12 +1,14 @@
 
 #include "Nyx.H"
 #include "Nyx_F.H"
+#include "AtomicRatesCache.H"
 
 using namespace amrex;
 using std::string;
 
 void
-Nyx::strang_first_step (Real time, Real dt, MultiFab& S_old, MultiFab& D_old)
+Nyx::strang_first_step (Real time, Real dt, MultiFab& S_old, MultiFab& D_old,
+                         bool fill_ghosts)
 {
     BL_PROFILE("Nyx::strang_first_step()");
     
@@ -19,7 +21,7 @@ Nyx::strang_first_step (Real time, Real dt, MultiFab& S_old, MultiFab& D_old)
 #ifndef FORCING
     {
       const Real z = 1.0/a - 1.0;
-      fort_interp_to_this_z(&z);
+      AtomicRatesCache::interp_to_z(z);
       /*      int neq=1;
       AMREX_LAUNCH_DEVICE_LAMBDA(neq,i,
                                  {
@@ -71,8 +73,10 @@ Nyx::strang_first_step (Real time, Real dt, MultiFab& S_old, MultiFab& D_old)
           {
             //#ifdef CVODE_LIBS
             int ierr=integrate_state_box(S_old,       D_old,       a, half_dt);
-            S_old.FillBoundary(geom.periodicity());
-            D_old.FillBoundary(geom.periodicity());
+            if (fill_ghosts) {
+                S_old.FillBoundary(geom.periodicity());
+                D_old.FillBoundary(geom.periodicity());
+            }
             if(ierr)
               amrex::Abort("error out of integrate_state_box");
           }
@@ -80,8 +84,10 @@ Nyx::strang_first_step (Real time, Real dt, MultiFab& S_old, MultiFab& D_old)
           {
             //#ifdef CVODE_LIBS
             int ierr=integrate_state_vec(S_old,       D_old,       a, half_dt);
-            S_old.FillBoundary(geom.periodicity());
-            D_old.FillBoundary(geom.periodicity());
+            if (fill_ghosts) {
+                S_old.FillBoundary(geom.periodicity());
+                D_old.FillBoundary(geom.periodicity());
+            }
             // Not sure how to fill patches
             //    FillPatch(*this, S_old, NUM_GROW, time, State_Type, 0, NUM_STATE);
             if(ierr)
@@ -91,8 +97,10 @@ Nyx::strang_first_step (Real time, Real dt, MultiFab& S_old, MultiFab& D_old)
           {
             //#ifdef CVODE_LIBS
             int ierr=integrate_state_cell(S_old,       D_old,       a, half_dt);
-            S_old.FillBoundary(geom.periodicity());
-            D_old.FillBoundary(geom.periodicity());
+            if (fill_ghosts) {
+                S_old.FillBoundary(geom.periodicity());
+                D_old.FillBoundary(geom.periodicity());
+            }
             if(ierr)
               amrex::Abort("error out of integrate_state_cell");
           }
@@ -174,7 +182,7 @@ Nyx::strang_second_step (Real time, Real dt, MultiFab& S_new, MultiFab& D_new)
 #ifndef FORCING
     {
       const Real z = 1.0/a - 1.0;
-      fort_interp_to_this_z(&z);
+      AtomicRatesCache::interp_to_z(z);
       /*      int neq=1;
       AMREX_LAUNCH_DEVICE_LAMBDA(neq,i,
       {
@@ -183,9 +191,26 @@ Nyx::strang_second_step (Real time, Real dt, MultiFab& S_new, MultiFab& D_new)
     }
 #endif
 
+    // These integrators finish each cell with an EOS solve of the updated (rho e),
+    // so Temp/Ne already match the state and the hydro dt limit is taken there
+    diag_eos_current = reuse_heat_cool_temp &&
+                       (heat_cool_type == 3  || heat_cool_type == 5  || heat_cool_type == 7 ||
+                        heat_cool_type == 9  || heat_cool_type == 10 || heat_cool_type == 11 ||
+                        heat_cool_type == 12);
+    Real* cfl_dt = diag_eos_current ? &hydro_cfl_dt : nullptr;
+
     /////////////////////Consider adding ifdefs for whether CVODE is compiled in for these statements
     if(heat_cool_type == 3 || heat_cool_type==5 || heat_cool_type==7 || heat_cool_type==9)
       {
+        ReduceOps<ReduceOpMin> reduce_op;
+        ReduceData<Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+
+        const auto dx = geom.CellSizeArray();
+        const Real sound_speed_factor = std::sqrt(gamma*(gamma-1));
+        const Real small_dens_in = small_dens;
+        const int  max_temp_dt_in = max_temp_dt;
+
         Gpu::streamSynchronize();
         Gpu::LaunchSafeGuard lsg(false);
 #ifdef _OPENMP
@@ -213,8 +238,24 @@ Nyx::strang_second_step (Real time, Real dt, MultiFab& S_new, MultiFab& D_new)
 
         min_iter = std::min(min_iter,min_iter_grid);
         max_iter = std::max(max_iter,max_iter_grid);
+
+        if (cfl_dt)
+        {
+            const auto u = S_new.const_array(mfi);
+            reduce_op.eval(bx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                return hydro_cell_dt(i, j, k, u, dx, sound_speed_factor,
+                                     small_dens_in, max_temp_dt_in);
+            });
+        }
     }
 
+        if (cfl_dt)
+        {
+            ReduceTuple hv = reduce_data.value();
+            *cfl_dt = amrex::get<0>(hv);
+        }
       }
     else if(heat_cool_type == 4)
       {
@@ -225,7 +266,7 @@ Nyx::strang_second_step (Real time, Real dt, MultiFab& S_new, MultiFab& D_new)
     else if(heat_cool_type== 10)
       {
         //#ifdef CVODE_LIBS
-    int ierr=integrate_state_box(S_new,       D_new,       a, half_dt);
+    int ierr=integrate_state_box(S_new,       D_new,       a, half_dt, cfl_dt);
     if(ierr)
       amrex::Abort("error out of integrate_state_box");
       }
@@ -234,20 +275,22 @@ Nyx::strang_second_step (Real time, Real dt, MultiFab& S_new, MultiFab& D_new)
         //#ifdef CVODE_LIBS
           if(use_typical_steps)
               amrex::ParallelDescriptor::ReduceLongMax(old_max_sundials_steps);
-    int ierr=integrate_state_vec(S_new,       D_new,       a, half_dt);
+    int ierr=integrate_state_vec(S_new,       D_new,       a, half_dt, cfl_dt);
     if(ierr)
       amrex::Abort("error out of integrate_state_box");
       }
     else if(heat_cool_type== 12)
       {
         //#ifdef CVODE_LIBS
-    int ierr=integrate_state_cell(S_new,       D_new,       a, half_dt);
+    int ierr=integrate_state_cell(S_new,       D_new,       a, half_dt, cfl_dt);
     if(ierr)
       amrex::Abort("error out of integrate_state_cell");
       }
     else
             amrex::Abort("Invalid heating cooling type");
 
+    hydro_cfl_dt_current = diag_eos_current;
+
     if(heat_cool_type == 3 || heat_cool_type==5 || heat_cool_type==7 || heat_cool_type==9)
     {
         ParallelDescriptor::ReduceIntMax(max_iter);
@@ -267,13 +310,27 @@ Nyx::strang_second_step (Real time, Real dt, MultiFab& S_new, MultiFab& D_new)
         const int IOProc   = ParallelDescriptor::IOProcessorNumber();
         Real      run_time = ParallelDescriptor::second() - strt_time;
 
+        // Newton-Raphson ne iterations since the last report, i.e. over this level's advance
+        long ne_iters = 0, ne_solves = 0;
+#ifdef HEATCOOL
+        fort_get_ne_iter_stats(&ne_iters, &ne_solves);
+#endif
+
 #ifdef BL_LAZY
         Lazy::QueueReduction( [=] () mutable {
 #endif
         ParallelDescriptor::ReduceRealMax(run_time,IOProc);
+        ParallelDescriptor::ReduceLongSum(ne_iters,IOProc);
+        ParallelDescriptor::ReduceLongSum(ne_solves,IOProc);
 
         if (ParallelDescriptor::IOProcessor())
+        {
+          if (ne_solves > 0)
+            std::cout << "Nyx::strang_second_step() level " << level
+                      << " ne Newton iterations = " << ne_iters << " over " << ne_solves
+                      << " solves (" << Real(ne_iters)/Real(ne_solves) << " per solve)" << "\n";
           std::cout << "Nyx::strang_second_step() time = " << run_time << "\n" << "\n";
+        }
 #ifdef BL_LAZY
         });
 #endif
@@ -281,11 +281,16 @@ Nyx::compute_average_temperature (Real& average_temperature)
         MultiFab& S_new = nyx_lev.get_new_data(State_Type);
         MultiFab& D_new = nyx_lev.get_new_data(DiagEOS_Type);
 
-        MultiFab reset_e_src(S_new.boxArray(), S_new.DistributionMap(), 1, NUM_GROW);
-        reset_e_src.setVal(0.0);
+        if (!nyx_lev.diag_eos_current)
+        {
+            MultiFab reset_e_src(S_new.boxArray(), S_new.DistributionMap(), 1, NUM_GROW);
+            reset_e_src.setVal(0.0);
 
-        nyx_lev.reset_internal_energy(S_new,D_new,reset_e_src);
-        nyx_lev.compute_new_temp     (S_new,D_new);
+            nyx_lev.reset_internal_energy(S_new,D_new,reset_e_src);
+            nyx_lev.compute_new_temp     (S_new,D_new,&nyx_lev.hydro_cfl_dt);
+            nyx_lev.diag_eos_current = true;
+            nyx_lev.hydro_cfl_dt_current = true;
+        }
 
         average_temperature += nyx_lev.vol_weight_sum("Temp",time,true);
 
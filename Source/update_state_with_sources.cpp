@@ -1,5 +1,6 @@
 #include "Nyx.H"
 #include "Nyx_F.H"
+#include "HydroStageTimers.H"
 
 using namespace amrex;
 
@@ -12,6 +13,8 @@ Nyx::update_state_with_sources( MultiFab& S_old, MultiFab& S_new,
                                 amrex::Real dt, amrex::Real a_old, amrex::Real a_new)
 {
     BL_PROFILE("Nyx::update_state_with_sources()");
+    HydroStageTimer stage_timer;
+    stage_timer.mark(HydroStageTimers::Update);
     if (verbose && ParallelDescriptor::IOProcessor())
       std::cout << "Updating state with the hydro sources ... " << std::endl;
     MultiFab::RegionTag amrhydro_tag("HydroUpdate_" + std::to_string(level));